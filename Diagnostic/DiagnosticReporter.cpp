@@ -5,12 +5,17 @@ void DiagnosticReporter::add(DiagSeverity sev, const string &code, const string
     items.push_back({sev, code, msg, line, col, len});
 }
 
+void DiagnosticReporter::lexical(const string &msg, int line, int col, int len)
+{
+    add(DiagSeverity::Error, "E0", "Lỗi từ vựng: " + msg, line, col, len);
+}
+
 void DiagnosticReporter::syntax(const string &msg, int line, int col, int len)
 {
     add(DiagSeverity::Error, "E1", "Lỗi cú pháp: " + msg, line, col, len);
 }
 
-void DiagnosticReporter::undeclared(const string &name, int line, int col, int len, const string &suggestion)
+string DiagnosticReporter::undeclaredMessage(const string &name, const string &suggestion)
 {
     string msg = "Biến '" + name + "' chưa được khai báo";
 
@@ -18,8 +23,72 @@ void DiagnosticReporter::undeclared(const string &name, int line, int col, int l
     {
         msg += ". Có phải ý bạn là '" + suggestion + "'?";
     }
+    return msg;
+}
 
-    add(DiagSeverity::Error, "E2", msg, line, col, len);
+size_t DiagnosticReporter::undeclared(const string &name, int line, int col, int len, const string &suggestion)
+{
+    add(DiagSeverity::Error, "E2", undeclaredMessage(name, suggestion), line, col, len);
+    return items.size() - 1;
+}
+
+void DiagnosticReporter::setSuggestion(size_t index, const string &name, const string &suggestion)
+{
+    if (index < items.size())
+        items[index].message = undeclaredMessage(name, suggestion);
+}
+
+void DiagnosticReporter::setSuggestionResolver(SuggestionResolver r)
+{
+    resolver = std::move(r);
+}
+
+size_t DiagnosticReporter::undeclaredDeferred(const string &name, int line, int col, int len, size_t handle)
+{
+    size_t index = undeclared(name, line, col, len);
+    if (resolver)
+        pending[index] = {name, handle};
+    return index;
+}
+
+bool DiagnosticReporter::suggestionPending(size_t index) const
+{
+    return pending.count(index) > 0;
+}
+
+void DiagnosticReporter::resolveSuggestions(const vector<size_t> &indices)
+{
+    vector<size_t> waiting;
+    vector<size_t> handles;
+    for (size_t index : indices)
+    {
+        auto it = pending.find(index);
+        if (it == pending.end())
+            continue;
+        waiting.push_back(index);
+        handles.push_back(it->second.handle);
+    }
+    if (waiting.empty() || !resolver)
+        return;
+
+    vector<string> suggestions = resolver(handles);
+    for (size_t i = 0; i < waiting.size(); i++)
+    {
+        auto it = pending.find(waiting[i]);
+        if (it == pending.end())
+            continue; // Trùng chỉ số trong indices
+        if (i < suggestions.size() && !suggestions[i].empty())
+            setSuggestion(waiting[i], it->second.name, suggestions[i]);
+        pending.erase(it);
+    }
+}
+
+void DiagnosticReporter::resolveAllSuggestions()
+{
+    vector<size_t> indices;
+    for (const auto &entry : pending)
+        indices.push_back(entry.first);
+    resolveSuggestions(indices);
 }
 
 void DiagnosticReporter::redeclaration(const string &name, int line, int col, int len)
@@ -37,7 +106,28 @@ bool DiagnosticReporter::empty() const
     return items.empty();
 }
 
+void DiagnosticReporter::replaceInLines(const string &code, int firstLine, int lastLine,
+                                        const vector<DiagnosticItem> &replacement)
+{
+    vector<DiagnosticItem> kept;
+    unordered_map<size_t, PendingSuggestion> remapped;
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        if (items[i].code == code && items[i].line >= firstLine && items[i].line <= lastLine)
+            continue;
+        auto it = pending.find(i);
+        if (it != pending.end())
+            remapped[kept.size()] = it->second;
+        kept.push_back(std::move(items[i]));
+    }
+    kept.insert(kept.end(), replacement.begin(), replacement.end());
+    items.swap(kept);
+    pending.swap(remapped);
+}
+
 void DiagnosticReporter::clear()
 {
     items.clear();
+    pending.clear();
+    resolver = nullptr;
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <functional>
+#include <unordered_map>
 using namespace std;
 
 enum class DiagSeverity
@@ -20,16 +22,48 @@ struct DiagnosticItem
     int length;
 };
 
+// Giải các gợi ý hoãn lại theo handle: trả về gợi ý tốt nhất cho từng handle ("" nếu không có)
+using SuggestionResolver = function<vector<string>(const vector<size_t> &handles)>;
+
 class DiagnosticReporter
 {
     vector<DiagnosticItem> items;
 
+    // Chẩn đoán E2 chưa có gợi ý: message chỉ đầy đủ sau resolveSuggestions
+    struct PendingSuggestion
+    {
+        string name;
+        size_t handle;
+    };
+    unordered_map<size_t, PendingSuggestion> pending;
+    SuggestionResolver resolver;
+
+    static string undeclaredMessage(const string &name, const string &suggestion);
+
 public:
     void add(DiagSeverity sev, const string &code, const string &msg, int line, int col, int len);
+    void lexical(const string &msg, int line, int col, int len);
     void syntax(const string &msg, int line, int col, int len);
-    void undeclared(const string &name, int line, int col, int len, const string &suggestion = "");
+    // Trả về vị trí của chẩn đoán để gắn gợi ý sau (setSuggestion)
+    size_t undeclared(const string &name, int line, int col, int len, const string &suggestion = "");
+    void setSuggestion(size_t index, const string &name, const string &suggestion);
+
+    // Gợi ý tìm khi cần (hiển thị, hover, xuất JSON) thay vì lúc parse
+    void setSuggestionResolver(SuggestionResolver r);
+    size_t undeclaredDeferred(const string &name, int line, int col, int len, size_t handle);
+    bool suggestionPending(size_t index) const;
+    // Giải chung một lần các chẩn đoán được chỉ định (bỏ qua chẩn đoán không chờ gợi ý)
+    void resolveSuggestions(const vector<size_t> &indices);
+    void resolveAllSuggestions();
+
     void redeclaration(const string &name, int line, int col, int len);
+
+    // Thay các chẩn đoán mã code trong các dòng [firstLine, lastLine] bằng replacement
+    // (dùng cho tầng phân tích chỉ chạy trên một vùng). Chẩn đoán khác giữ nguyên
+    // thứ tự; chỉ số của chúng và gợi ý đang chờ được đánh lại.
+    void replaceInLines(const string &code, int firstLine, int lastLine, const vector<DiagnosticItem> &replacement);
     
+    // message của chẩn đoán đang chờ gợi ý chưa có phần "Có phải ý bạn là"
     const vector<DiagnosticItem> &all() const;
     bool empty() const;
     void clear();
@@ -25,3 +25,10 @@ string Diagnostic_to_JSON(const vector<DiagnosticItem> &items)
     o << "\n  ]\n}";
     return o.str();
 }
+
+// Xuất từ reporter: giải hết các gợi ý đang hoãn trước khi ghi
+inline string Diagnostic_to_JSON(DiagnosticReporter &reporter)
+{
+    reporter.resolveAllSuggestions();
+    return Diagnostic_to_JSON(reporter.all());
+}
@@ -0,0 +1,168 @@
+#include "acronym_index.h"
+#include "string_pool.h"
+#include <algorithm>
+#include <cctype>
+
+void splitIdentifier(string_view word, vector<pair<size_t, size_t>> &segments, bool forQuery)
+{
+    segments.clear();
+    size_t start = string_view::npos;
+
+    for (size_t i = 0; i < word.size(); i++)
+    {
+        unsigned char c = word[i];
+        if (!isalnum(c))
+        {
+            if (start != string_view::npos)
+                segments.push_back({start, i});
+            start = string_view::npos;
+            continue;
+        }
+
+        bool boundary = false;
+        if (start != string_view::npos)
+        {
+            unsigned char prev = word[i - 1];
+            if (isdigit(c) != isdigit(prev))
+                boundary = true;
+            else if (isupper(c) && (forQuery || islower(prev)))
+                boundary = true;
+            else if (isupper(prev) && isupper(c) && i + 1 < word.size() && islower((unsigned char)word[i + 1]))
+                boundary = true;
+        }
+
+        if (boundary)
+        {
+            segments.push_back({start, i});
+            start = i;
+        }
+        else if (start == string_view::npos)
+        {
+            start = i;
+        }
+    }
+
+    if (start != string_view::npos)
+        segments.push_back({start, word.size()});
+}
+
+void splitAbbreviation(string_view abbrev, vector<pair<size_t, size_t>> &query)
+{
+    splitIdentifier(abbrev, query, true);
+    if (!all_of(abbrev.begin(), abbrev.end(), [](unsigned char c) { return islower(c) || isdigit(c); }))
+        return;
+
+    vector<pair<size_t, size_t>> letters;
+    for (auto [from, to] : query)
+    {
+        if (isdigit((unsigned char)abbrev[from]))
+            letters.push_back({from, to});
+        else
+            for (size_t i = from; i < to; i++)
+                letters.push_back({i, i + 1});
+    }
+    query.swap(letters);
+}
+
+bool matchesAbbreviation(string_view abbrev, const vector<pair<size_t, size_t>> &query,
+                         string_view word, const vector<pair<size_t, size_t>> &segments)
+{
+    if (segments.size() < query.size())
+        return false;
+    for (size_t i = 0; i < query.size(); i++)
+    {
+        size_t qLen = query[i].second - query[i].first;
+        size_t wLen = segments[i].second - segments[i].first;
+        if (qLen > wLen)
+            return false;
+        for (size_t j = 0; j < qLen; j++)
+        {
+            if (tolower(abbrev[query[i].first + j]) != tolower(word[segments[i].first + j]))
+                return false;
+        }
+    }
+    return true;
+}
+
+string AcronymIndex::initials(string_view word)
+{
+    static thread_local vector<pair<size_t, size_t>> segments;
+    splitIdentifier(word, segments);
+
+    string result;
+    for (auto [from, to] : segments)
+        result += tolower(word[from]);
+    return result;
+}
+
+void AcronymIndex::add(uint32_t wordId, string_view word)
+{
+    string key = initials(word);
+    if (key.size() >= 2)
+        byInitials[key].push_back(wordId);
+}
+
+void AcronymIndex::remove(uint32_t wordId, string_view word)
+{
+    auto it = byInitials.find(initials(word));
+    if (it == byInitials.end())
+        return;
+
+    auto &ids = it->second;
+    ids.erase(std::remove(ids.begin(), ids.end(), wordId), ids.end());
+    if (ids.empty())
+        byInitials.erase(it);
+}
+
+void AcronymIndex::find(const string &abbrev, const StringPool &words, size_t limit, vector<uint32_t> &out) const
+{
+    out.clear();
+
+    vector<pair<size_t, size_t>> query;
+    splitAbbreviation(abbrev, query);
+    if (query.size() < 2 || limit == 0)
+        return;
+
+    string key;
+    for (auto [from, to] : query)
+        key += tolower(abbrev[from]);
+
+    // Chặn trên số ứng viên kiểm tra để độ trễ không phụ thuộc kích thước từ điển
+    const size_t MAX_CANDIDATES = 1024;
+    size_t scanned = 0;
+    static thread_local vector<pair<size_t, size_t>> segments;
+    vector<pair<pair<size_t, size_t>, uint32_t>> found; // ((đoạn thừa, độ dài), ID)
+
+    // Mọi khóa bắt đầu bằng key nằm liên tiếp trong map
+    for (auto it = byInitials.lower_bound(key);
+         it != byInitials.end() && it->first.compare(0, key.size(), key) == 0 && scanned < MAX_CANDIDATES; ++it)
+    {
+        // Khóa dài hơn key nghĩa là còn đoạn thừa: chỉ cần khi khóa đúng bằng key chưa đủ
+        if (it->first.size() > key.size() && found.size() >= limit)
+            break;
+
+        for (uint32_t id : it->second)
+        {
+            scanned++;
+            string_view word = words.view(id);
+            splitIdentifier(word, segments);
+
+            if (matchesAbbreviation(abbrev, query, word, segments))
+                found.push_back({{segments.size() - query.size(), word.size()}, id});
+        }
+    }
+
+    size_t keep = min(limit, found.size());
+    partial_sort(found.begin(), found.begin() + keep, found.end());
+    for (size_t i = 0; i < keep; i++)
+        out.push_back(found[i].second);
+}
+
+size_t AcronymIndex::bytes() const
+{
+    // Ước lượng: node cây đỏ-đen (3 con trỏ + màu) cộng khóa và danh sách ID
+    size_t total = 0;
+    for (const auto &entry : byInitials)
+        total += 4 * sizeof(void *) + sizeof(entry) + entry.first.capacity() + entry.second.capacity() * sizeof(uint32_t);
+    return total;
+}
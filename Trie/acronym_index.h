@@ -0,0 +1,51 @@
+#ifndef ACRONYM_INDEX_H
+#define ACRONYM_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+
+using namespace std;
+
+class StringPool;
+
+// Đoạn [first, second) của định danh giữa các ranh giới từ:
+// '_' (và ký tự không phải chữ/số), chữ thường -> chữ hoa, dãy chữ số,
+// dãy chữ hoa trước một từ viết hoa ("HTTPServer" -> HTTP, Server).
+// Với truy vấn (forQuery) mọi chữ hoa đều mở đoạn mới ("gCC" -> g, C, C).
+void splitIdentifier(string_view word, vector<pair<size_t, size_t>> &segments, bool forQuery = false);
+
+// Các đoạn của truy vấn viết tắt: truy vấn không có chữ hoa hay dấu phân tách
+// ("gcc", "rc2") thì mỗi chữ cái là một đoạn, dãy chữ số vẫn là một đoạn
+void splitAbbreviation(string_view abbrev, vector<pair<size_t, size_t>> &query);
+// Đoạn thứ i của truy vấn là tiền tố (không phân biệt hoa thường) của đoạn thứ i
+// của từ; segments là các đoạn của word (splitIdentifier)
+bool matchesAbbreviation(string_view abbrev, const vector<pair<size_t, size_t>> &query,
+                         string_view word, const vector<pair<size_t, size_t>> &segments);
+
+// Chỉ mục viết tắt: chữ cái đầu (chữ thường) của các đoạn -> từ.
+// "gcc" tìm ra getCharCount, "rbs" tìm ra read_buffer_size, "getChCo" cũng
+// tìm ra getCharCount: mỗi đoạn của truy vấn là tiền tố của đoạn tương ứng.
+class AcronymIndex
+{
+    map<string, vector<uint32_t>> byInitials;
+
+public:
+    static string initials(string_view word);
+
+    void add(uint32_t wordId, string_view word);
+    void remove(uint32_t wordId, string_view word);
+
+    // Từ khớp viết tắt abbrev (ít nhất 2 đoạn), ưu tiên từ không còn đoạn thừa
+    // rồi tới từ ngắn; tối đa limit kết quả
+    void find(const string &abbrev, const StringPool &words, size_t limit, vector<uint32_t> &out) const;
+
+    size_t size() const { return byInitials.size(); }
+    size_t bytes() const;
+    void clear() { byInitials.clear(); }
+};
+
+#endif // ACRONYM_INDEX_H
@@ -0,0 +1,280 @@
+#include "completion_dictionary.h"
+#include <cctype>
+#include <algorithm>
+
+string CompletionDictionary::toLower(const string &s)
+{
+    string result = s;
+    for (char &c : result)
+        c = tolower(c);
+    return result;
+}
+
+CompletionDictionary::CompletionDictionary()
+{
+    words.prepareIndexes();
+}
+
+void CompletionDictionary::pin(const string &word)
+{
+    Pin &entry = pinned[toLower(word)];
+    if (entry.sources++ == 0)
+    {
+        entry.spelling = word;
+        words.insert(word);
+    }
+}
+
+void CompletionDictionary::unpin(const string &word)
+{
+    string lower = toLower(word);
+    auto it = pinned.find(lower);
+    if (it == pinned.end() || --it->second.sources > 0)
+        return;
+    string spelling = std::move(it->second.spelling);
+    pinned.erase(it);
+
+    if (!lowerCounts.count(lower))
+    {
+        words.remove(spelling);
+        words.prepareIndexes();
+        // Ảnh nền có thể đã lưu tên này khi thư viện còn được include
+        if (base && base->contains(spelling))
+            hidden.insert(lower);
+        return;
+    }
+    // Tên vẫn dùng trong mã: hiển thị cách viết trong mã thay vì cách viết của thư viện
+    if (!counts.count(spelling))
+    {
+        for (const auto &entry : counts)
+        {
+            if (toLower(entry.first) == lower)
+            {
+                words.insert(entry.first);
+                break;
+            }
+        }
+    }
+}
+
+void CompletionDictionary::setLibraries(const unordered_map<string, vector<string>> &libraries)
+{
+    // Ghim trước khi nhả: tên chung của hai thư viện (abs của math.h và cmath) không rơi khỏi trie
+    for (const auto &lib : libraries)
+    {
+        if (!libraryPins.emplace(lib.first, lib.second).second)
+            continue;
+        for (const auto &ident : lib.second)
+            pin(ident);
+    }
+    for (auto it = libraryPins.begin(); it != libraryPins.end();)
+    {
+        if (libraries.count(it->first))
+        {
+            ++it;
+            continue;
+        }
+        for (const auto &ident : it->second)
+            unpin(ident);
+        it = libraryPins.erase(it);
+    }
+}
+
+void CompletionDictionary::addReference(const string &name, int n)
+{
+    if (n <= 0)
+        return;
+
+    if (counts[name] == 0)
+        words.insert(name); // Cách viết mới nhất được hiển thị
+    counts[name] += n;
+    string lower = toLower(name);
+    int &total = lowerCounts[lower];
+    if (total == 0)
+        hidden.erase(lower); // Tên quay lại tài liệu
+    total += n;
+
+    // Xuất hiện thêm trong mã cũng là tín hiệu sử dụng
+    words.addWeight(name, n);
+}
+
+void CompletionDictionary::releaseReference(const string &name, int n)
+{
+    auto it = counts.find(name);
+    if (it == counts.end() || n <= 0)
+        return;
+
+    n = min(n, it->second);
+    it->second -= n;
+    bool spellingGone = it->second == 0;
+    if (spellingGone)
+        counts.erase(it);
+
+    string lower = toLower(name);
+    auto total = lowerCounts.find(lower);
+    total->second -= n;
+    if (total->second > 0)
+    {
+        // Cách viết này biến mất nhưng tên vẫn còn với cách viết khác ("Count"
+        // và "count"): hiển thị cách viết còn lại. Hiếm nên quét tuyến tính.
+        if (spellingGone)
+        {
+            for (const auto &entry : counts)
+            {
+                if (toLower(entry.first) == lower)
+                {
+                    words.insert(entry.first);
+                    break;
+                }
+            }
+        }
+        return;
+    }
+
+    lowerCounts.erase(total);
+    auto pin = pinned.find(lower);
+    if (pin != pinned.end())
+    {
+        // Tên vẫn được ghim: hiện lại cách viết của keyword/thư viện ("Printf" -> "printf")
+        words.insert(pin->second.spelling);
+        return;
+    }
+    words.remove(name);
+    words.prepareIndexes(); // Thu gọn kho chuỗi bỏ chỉ mục cũ: dựng lại ngay
+    if (base && base->contains(name))
+        hidden.insert(lower);
+}
+
+void CompletionDictionary::applyCounts(unordered_map<string, int> current)
+{
+    // Chỉ các tên có số lần thay đổi mới chạm vào trie
+    vector<pair<string, int>> released;
+    for (const auto &entry : counts)
+    {
+        auto now = current.find(entry.first);
+        int after = now == current.end() ? 0 : now->second;
+        if (after < entry.second)
+            released.push_back({entry.first, entry.second - after});
+    }
+
+    // Thêm trước khi bớt: đổi cách viết ("count" -> "Count") không làm rơi node
+    for (const auto &entry : current)
+    {
+        auto before = counts.find(entry.first);
+        int previous = before == counts.end() ? 0 : before->second;
+        if (entry.second > previous)
+            addReference(entry.first, entry.second - previous);
+    }
+    for (const auto &entry : released)
+        releaseReference(entry.first, entry.second);
+}
+
+void CompletionDictionary::setBaseImage(shared_ptr<const TrieImage> image)
+{
+    base = std::move(image);
+    hidden.clear();
+}
+
+bool CompletionDictionary::showFromBase(const string &word, unordered_set<string> &seen) const
+{
+    string lower = toLower(word);
+    return !hidden.count(lower) && seen.insert(lower).second;
+}
+
+vector<pair<string, uint32_t>> CompletionDictionary::imageEntries() const
+{
+    vector<pair<string, uint32_t>> entries;
+    unordered_set<string> live;
+    words.forEachWord([&](string_view word, uint32_t weight)
+                      {
+        string spelling(word);
+        entries.push_back({spelling, weight + (base ? base->weight(spelling) / 2 : 0)});
+        live.insert(toLower(spelling)); });
+
+    if (base)
+    {
+        base->forEachWord([&](string_view word, uint32_t weight)
+                          {
+            string lower = toLower(string(word));
+            if (weight / 2 > 0 && !live.count(lower) && !hidden.count(lower))
+                entries.push_back({string(word), weight / 2}); });
+    }
+    return entries;
+}
+
+vector<string> CompletionDictionary::findWordsWithPrefix(const string &prefix, int limit) const
+{
+    if (!base)
+        return words.findWordsWithPrefix(prefix, limit);
+
+    // Gộp top-limit của hai lớp theo tổng trọng số (từ đã dùng ở phiên này và
+    // phiên trước được cộng cả hai phần); ảnh nền bỏ qua tên đã bị xóa
+    vector<pair<uint32_t, string>> ranked;
+    unordered_set<string> seen;
+    for (const auto &word : words.findWordsWithPrefix(prefix, limit))
+    {
+        seen.insert(toLower(word));
+        ranked.push_back({words.weight(word) + base->weight(word), word});
+    }
+    for (const auto &word : base->findWordsWithPrefix(prefix, limit, [this](const string &w) { return !hidden.count(toLower(w)); }))
+    {
+        if (seen.insert(toLower(word)).second)
+            ranked.push_back({words.weight(word) + base->weight(word), word});
+    }
+    stable_sort(ranked.begin(), ranked.end(),
+                [](const pair<uint32_t, string> &a, const pair<uint32_t, string> &b) { return a.first > b.first; });
+
+    vector<string> result;
+    for (int i = 0; i < min(limit, (int)ranked.size()); i++)
+        result.push_back(ranked[i].second);
+    return result;
+}
+
+vector<string> CompletionDictionary::findWordsByAbbreviation(const string &abbrev, int limit) const
+{
+    vector<string> result = words.findWordsByAbbreviation(abbrev, limit);
+    if (!base || (int)result.size() >= limit)
+        return result;
+
+    // Tên của tài liệu trước, rồi tới tên chỉ có trong ảnh nền
+    unordered_set<string> seen;
+    for (const auto &word : result)
+        seen.insert(toLower(word));
+    for (const auto &word : base->findWordsByAbbreviation(abbrev, limit, [&](const string &w) { return showFromBase(w, seen); }))
+    {
+        if ((int)result.size() >= limit)
+            break;
+        result.push_back(word);
+    }
+    return result;
+}
+
+vector<string> CompletionDictionary::findSimilarWords(const string &word, int limit) const
+{
+    // Bản batch là const: đọc đồng thời được như các truy vấn khác
+    vector<string> result = words.findSimilarWordsBatch({word}, limit)[0];
+    if (!base || (int)result.size() >= limit)
+        return result;
+
+    unordered_set<string> seen;
+    for (const auto &w : result)
+        seen.insert(toLower(w));
+    for (const auto &w : base->findSimilarWords(word, limit, [&](const string &candidate) { return showFromBase(candidate, seen); }))
+    {
+        if ((int)result.size() >= limit)
+            break;
+        result.push_back(w);
+    }
+    return result;
+}
+
+void CompletionDictionary::clear()
+{
+    words.clear();
+    counts.clear();
+    lowerCounts.clear();
+    pinned.clear();
+    libraryPins.clear();
+    hidden.clear();
+    words.prepareIndexes();
+}
@@ -0,0 +1,83 @@
+#ifndef COMPLETION_DICTIONARY_H
+#define COMPLETION_DICTIONARY_H
+
+#include "trie.h"
+#include "trie_image.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+// Từ điển completion theo số tham chiếu: mỗi identifier được đếm số lần xuất
+// hiện trong tài liệu, chỉ phần chênh lệch giữa hai lần quét chạm vào trie.
+// Tên không còn xuất hiện bị xóa khỏi trie; keyword và identifier thư viện
+// được ghim (pin) nên không bị xóa khi vắng trong mã. Ghim được đếm theo nguồn
+// (keyword, từng thư viện đang #include): bỏ #include thì nhả ghim của thư viện đó.
+// Chỉ mục phụ của trie luôn được dựng sẵn: các truy vấn là const và không ghi
+// gì, nên nhiều luồng đọc cùng lúc được (xem ConcurrentDictionary).
+// Tùy chọn có một ảnh nền (TrieImage, mmap từ phiên trước) chỉ đọc: completion
+// có ngay khi mở, trước lần phân tích đầu tiên. Trie là lớp phủ ghi được, truy
+// vấn gộp kết quả của cả hai lớp. Tên rời khỏi tài liệu được đánh dấu (tombstone)
+// để ảnh nền không gợi ý lại chúng; ảnh không bao giờ bị sửa.
+class CompletionDictionary
+{
+    Trie words;
+    unordered_map<string, int> counts;       // Số lần xuất hiện theo cách viết
+    unordered_map<string, int> lowerCounts;  // Tổng theo chữ thường (trie không phân biệt hoa thường)
+    struct Pin
+    {
+        int sources;     // Số nguồn đang ghim
+        string spelling; // Cách viết của nguồn ghim, hiện lại khi tên rời khỏi mã
+    };
+    unordered_map<string, Pin> pinned;       // Chữ thường -> ghim
+    unordered_map<string, vector<string>> libraryPins; // Thư viện đang include -> identifiers đã ghim
+    shared_ptr<const TrieImage> base;        // Dùng chung giữa các bản sao, không bị sửa
+    unordered_set<string> hidden;            // Chữ thường: tên của ảnh nền đã bị xóa khỏi tài liệu
+
+    static string toLower(const string &s);
+    // Từ của ảnh nền được gợi ý: không bị xóa khỏi tài liệu, chưa có trong trie
+    bool showFromBase(const string &word, unordered_set<string> &seen) const;
+
+public:
+    CompletionDictionary();
+
+    void pin(const string &word);
+    // Nhả một lần ghim; tên hết ghim và không còn trong mã bị xóa khỏi trie
+    void unpin(const string &word);
+    // Tập thư viện đang #include và identifiers của chúng: ghim thư viện mới,
+    // nhả ghim của thư viện không còn được include
+    void setLibraries(const unordered_map<string, vector<string>> &libraries);
+    void addReference(const string &name, int n = 1);
+    void releaseReference(const string &name, int n = 1);
+
+    // Cập nhật theo multiset identifier hiện tại của tài liệu (đếm từ token)
+    void applyCounts(unordered_map<string, int> current);
+
+    // Gợi ý được chọn: tăng trọng số
+    void addWeight(const string &word, uint32_t amount) { words.addWeight(word, amount); }
+
+    // Ảnh nền cho các từ đã biết từ phiên trước; nullptr để bỏ (nhả mmap)
+    void setBaseImage(shared_ptr<const TrieImage> image);
+    // Các từ đang sống và trọng số, để ghi ảnh cho phiên sau (TrieImage::save).
+    // Từ của ảnh nền chưa bị xóa được giữ với nửa trọng số cũ (trọng số không
+    // tăng mãi qua các phiên; từ không dùng tới trọng số 0 thì bị bỏ).
+    vector<pair<string, uint32_t>> imageEntries() const;
+
+    vector<string> findWordsWithPrefix(const string &prefix, int limit = 10) const;
+    vector<string> findWordsByAbbreviation(const string &abbrev, int limit = 10) const;
+    // Chỉ trong trie: ảnh nền không có chỉ mục trigram
+    vector<string> findWordsContaining(const string &text, int limit = 10) const { return words.findWordsContaining(text, limit); }
+    // Lỗi gõ ("pirntf" -> printf): automaton trên trie, rồi trên ảnh nền
+    vector<string> findSimilarWords(const string &word, int limit = 5) const;
+
+    // Gần đúng khi có ảnh nền (từ nằm ở cả hai lớp được đếm hai lần)
+    size_t size() const { return words.size() + (base ? base->size() : 0); }
+    const Trie &trie() const { return words; }
+    // Xóa cả các từ đã ghim; ảnh nền giữ nguyên
+    void clear();
+};
+
+#endif // COMPLETION_DICTIONARY_H
@@ -0,0 +1,25 @@
+#include "concurrent_dictionary.h"
+#include <thread>
+
+void ConcurrentDictionary::waitForReaders(int index) const
+{
+    // Query completion chỉ tốn vài micro giây: chờ quay thay vì dùng condition variable
+    while (readers[index].value.load() != 0)
+        this_thread::yield();
+}
+
+void ConcurrentDictionary::update(const function<void(CompletionDictionary &)> &batch)
+{
+    lock_guard<mutex> lock(writerMutex);
+
+    // Bản không công bố không còn reader (đã chờ ở lần ghi trước)
+    int current = published.load();
+    int next = 1 - current;
+    batch(instances[next]);
+
+    // Công bố: reader mới thấy bản next, reader đang đọc bản current đọc nốt
+    published.store(next);
+    waitForReaders(current);
+
+    batch(instances[current]);
+}
@@ -0,0 +1,73 @@
+#ifndef CONCURRENT_DICTIONARY_H
+#define CONCURRENT_DICTIONARY_H
+
+#include "completion_dictionary.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+using namespace std;
+
+// Từ điển completion cho một luồng ghi (phân tích nền) và nhiều luồng đọc (UI).
+// Giữ hai bản CompletionDictionary giống nhau (kỹ thuật left-right):
+// - Luồng đọc lấy bản đang công bố qua một chỉ số atomic, không khóa và không
+//   bao giờ chờ luồng ghi; mỗi bản có bộ đếm reader để biết khi nào hết người đọc.
+// - Luồng ghi áp cả lô thay đổi lên bản còn lại, đổi chỉ số công bố (atomic),
+//   chờ reader cũ rời bản kia (grace period kiểu RCU) rồi áp lại cùng lô đó
+//   để hai bản đồng bộ. Bản cũ được dùng lại thay vì giải phóng.
+// Chi phí ghi tỉ lệ với kích thước lô (x2), không phải với kích thước từ điển.
+class ConcurrentDictionary
+{
+    // Bộ đếm trên cache line riêng: reader hai bản không tranh chấp nhau
+    struct alignas(64) ReaderCount
+    {
+        atomic<int> value{0};
+    };
+
+    CompletionDictionary instances[2];
+    atomic<int> published{0};
+    mutable ReaderCount readers[2];
+    mutex writerMutex;
+
+    void waitForReaders(int index) const;
+
+public:
+    ConcurrentDictionary() = default;
+    ConcurrentDictionary(const ConcurrentDictionary &) = delete;
+    ConcurrentDictionary &operator=(const ConcurrentDictionary &) = delete;
+
+    // Chạy query trên bản đang công bố; bản đó không bị sửa cho tới khi query trả về
+    template <typename Query>
+    auto read(Query &&query) const -> decltype(query(declval<const CompletionDictionary &>()))
+    {
+        int index;
+        for (;;)
+        {
+            index = published.load();
+            readers[index].value.fetch_add(1);
+            // Luồng ghi có thể vừa đổi bản: kiểm tra lại sau khi đã đăng ký
+            if (published.load() == index)
+                break;
+            readers[index].value.fetch_sub(1);
+        }
+
+        struct Leave
+        {
+            atomic<int> &count;
+            ~Leave() { count.fetch_sub(1); }
+        } leave{readers[index].value};
+        return query(instances[index]);
+    }
+
+    // Áp một lô thay đổi và công bố phiên bản mới khi xong. batch được gọi hai
+    // lần (mỗi bản một lần) nên phải tất định và không tiêu thụ dữ liệu nó giữ.
+    void update(const function<void(CompletionDictionary &)> &batch);
+
+    size_t size() const
+    {
+        return read([](const CompletionDictionary &d) { return d.size(); });
+    }
+};
+
+#endif // CONCURRENT_DICTIONARY_H
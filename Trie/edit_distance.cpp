@@ -0,0 +1,96 @@
+#include "edit_distance.h"
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+
+EditDistancePattern::EditDistancePattern(const string &pattern)
+    : m(pattern.size()), blockCount((int)((pattern.size() + 63) / 64))
+{
+    memset(peq, 0, sizeof(peq));
+    if (blockCount > 1)
+    {
+        extraPeq.assign((blockCount - 1) * 256, 0);
+        pv.resize(blockCount);
+        mv.resize(blockCount);
+    }
+
+    for (size_t i = 0; i < m; i++)
+    {
+        uint64_t *block = (i < 64) ? peq : &extraPeq[(i / 64 - 1) * 256];
+        uint64_t bit = 1ULL << (i % 64);
+        unsigned char c = pattern[i];
+        block[(unsigned char)tolower(c)] |= bit;
+        block[(unsigned char)toupper(c)] |= bit;
+    }
+}
+
+int EditDistancePattern::run(const string &text, bool anchored) const
+{
+    if (m == 0)
+        return anchored ? text.size() : 0;
+
+    const uint64_t lastBit = 1ULL << ((m - 1) % 64);
+
+    if (blockCount == 1)
+    {
+        uint64_t Pv = ~0ULL, Mv = 0;
+        int score = m, best = m;
+        for (unsigned char c : text)
+        {
+            uint64_t Eq = peq[c];
+            uint64_t Xv = Eq | Mv;
+            uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+            uint64_t Ph = Mv | ~(Xh | Pv);
+            uint64_t Mh = Pv & Xh;
+            if (Ph & lastBit)
+                score++;
+            else if (Mh & lastBit)
+                score--;
+            Ph = (Ph << 1) | (anchored ? 1 : 0); // Hàng 0: D[0][j] = j, hoặc 0 khi tìm đoạn con
+            Mh <<= 1;
+            Pv = Mh | ~(Xv | Ph);
+            Mv = Ph & Xv;
+            best = min(best, score);
+        }
+        return anchored ? score : best;
+    }
+
+    // Biến thể chia khối: độ chênh ngang (-1/0/+1) truyền từ khối trên xuống khối dưới
+    for (int b = 0; b < blockCount; b++)
+    {
+        pv[b] = ~0ULL;
+        mv[b] = 0;
+    }
+    int score = m, best = m;
+    for (unsigned char c : text)
+    {
+        int carry = anchored ? 1 : 0;
+        for (int b = 0; b < blockCount; b++)
+        {
+            uint64_t Eq = blockPeq(b)[c];
+            uint64_t Pv = pv[b], Mv = mv[b];
+            uint64_t Xv = Eq | Mv;
+            if (carry < 0)
+                Eq |= 1;
+            uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+            uint64_t Ph = Mv | ~(Xh | Pv);
+            uint64_t Mh = Pv & Xh;
+
+            uint64_t high = (b == blockCount - 1) ? lastBit : (1ULL << 63);
+            int out = (Ph & high) ? 1 : ((Mh & high) ? -1 : 0);
+
+            Ph <<= 1;
+            Mh <<= 1;
+            if (carry < 0)
+                Mh |= 1;
+            else if (carry > 0)
+                Ph |= 1;
+            pv[b] = Mh | ~(Xv | Ph);
+            mv[b] = Ph & Xv;
+            carry = out;
+        }
+        score += carry;
+        best = min(best, score);
+    }
+    return anchored ? score : best;
+}
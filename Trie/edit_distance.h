@@ -0,0 +1,36 @@
+#ifndef EDIT_DISTANCE_H
+#define EDIT_DISTANCE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Khoảng cách Levenshtein bit-parallel (Myers / Hyyrö), không phân biệt hoa thường.
+// Bitmask của pattern được tính một lần cho mỗi truy vấn; mỗi lần so với một
+// ứng viên chỉ tốn O(ceil(m / 64) * n) phép toán bit và không cấp phát bộ nhớ.
+// Pattern dài hơn 64 ký tự dùng biến thể chia khối (mỗi khối 64 bit).
+class EditDistancePattern
+{
+    size_t m;
+    int blockCount;
+    uint64_t peq[256];             // Khối đầu tiên (đủ cho pattern <= 64 ký tự)
+    vector<uint64_t> extraPeq;     // Các khối sau: extraPeq[(b - 1) * 256 + c]
+    mutable vector<uint64_t> pv;   // Trạng thái dọc của từng khối (dùng lại giữa các lần gọi)
+    mutable vector<uint64_t> mv;
+
+    const uint64_t *blockPeq(int b) const { return b == 0 ? peq : &extraPeq[(b - 1) * 256]; }
+    // anchored: so khớp toàn bộ text; ngược lại pattern được bắt đầu ở bất kỳ đâu
+    int run(const string &text, bool anchored) const;
+
+public:
+    explicit EditDistancePattern(const string &pattern);
+
+    int distanceTo(const string &text) const { return run(text, true); }
+    // Khoảng cách nhỏ nhất giữa pattern và một đoạn con bất kỳ của text
+    int searchIn(const string &text) const { return run(text, false); }
+    size_t length() const { return m; }
+};
+
+#endif // EDIT_DISTANCE_H
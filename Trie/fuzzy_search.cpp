@@ -1,54 +1,49 @@
 #include "fuzzy_search.h"
 #include "trie.h"
+#include "edit_distance.h"
+#include "levenshtein_automaton.h"
+#include "symspell.h"
 #include <algorithm>
 #include <cctype>
-#include <queue>
 #include <cmath>
-#include <unordered_set>
+#include <climits>
+#include <thread>
 
-AStarState::AStarState(TrieNode *n, string word, int pos, int g, int h)
-    : node(n), currentWord(word), inputPos(pos), gCost(g), hCost(h), fCost(g + h) {}
-
-bool AStarState::operator>(const AStarState &other) const
+int calculateHeuristic(const TrieCursor &at, const string &input, int inputPos)
 {
-    if (fCost != other.fCost)
-        return fCost > other.fCost;
-    return currentWord.size() > other.currentWord.size();
+    int remainingInput = input.size() - inputPos;
+
+    // Độ dài: mỗi ký tự thừa/thiếu so với từ gần nhất trong cây con tốn 1 thao tác
+    int lengthBound = 0;
+    if (remainingInput < at.minRemaining())
+        lengthBound = at.minRemaining() - remainingInput;
+    else if (remainingInput > at.maxRemaining())
+        lengthBound = remainingInput - at.maxRemaining();
+
+    // Ký tự input không xuất hiện trong cây con phải bị xóa hoặc thay thế
+    uint32_t charMask = at.charMask();
+    int missing = 0;
+    for (int i = inputPos; i < (int)input.size(); i++)
+        if (!(charMask & (1u << (input[i] & 31))))
+            missing++;
+
+    return max(lengthBound, missing);
 }
 
-int calculateHeuristic(const string &input, int inputPos)
+int calculateEditDistance(const string &input, const string &candidate)
 {
-    int remainingInputChars = input.size() - inputPos;
-    return remainingInputChars;
+    // Chuỗi ngắn hơn làm pattern để ít khối bit nhất
+    if (candidate.size() < input.size())
+        return EditDistancePattern(candidate).distanceTo(input);
+    return EditDistancePattern(input).distanceTo(candidate);
 }
 
-int calculateEditDistance(const string &input, const string &candidate)
+int calculateRankingScore(const string &input, const string &candidate)
 {
-    int n = input.size();
-    int m = candidate.size();
-
-    vector<int> prev(m + 1), curr(m + 1);
-
-    for (int j = 0; j <= m; j++)
-        prev[j] = j;
-
-    for (int i = 1; i <= n; i++)
-    {
-        curr[0] = i;
-        for (int j = 1; j <= m; j++)
-        {
-            if (tolower(input[i - 1]) == tolower(candidate[j - 1]))
-                curr[j] = prev[j - 1];
-            else
-                curr[j] = 1 + min({prev[j], curr[j - 1], prev[j - 1]});
-        }
-        swap(prev, curr);
-    }
-
-    return prev[m];
+    return calculateRankingScore(input, candidate, -1);
 }
 
-int calculateRankingScore(const string &input, const string &candidate)
+int calculateRankingScore(const string &input, const string &candidate, int distance)
 {
     int prefixLen = 0;
     size_t minLen = min(input.size(), candidate.size());
@@ -67,7 +62,8 @@ int calculateRankingScore(const string &input, const string &candidate)
         return -10000 + (candidate.size() - input.size());
     }
 
-    int distance = calculateEditDistance(input, candidate);
+    if (distance < 0)
+        distance = calculateEditDistance(input, candidate);
     int lengthDiff = abs((int)candidate.size() - (int)input.size());
 
     int score = distance * 100; // Trọng số chính
@@ -77,141 +73,714 @@ int calculateRankingScore(const string &input, const string &candidate)
     return score;
 }
 
+int maxEditDistanceFor(size_t inputLength)
+{
+    if (inputLength <= 2)
+        return 2;
+    if (inputLength <= 4)
+        return 3;
+    return max(3, (int)(inputLength * 0.5));
+}
+
+namespace
+{
+    // Cận dưới ranking score (xem calculateRankingScore) cho mọi từ đi qua state
+    int rankingLowerBound(const AStarState &s, int inputLen)
+    {
+        TrieCursor at{s.node, s.pending};
+        int minLen = s.depth + at.minRemaining();
+        int maxLen = s.depth + at.maxRemaining();
+        int lengthDiff = inputLen < minLen ? minLen - inputLen : (inputLen > maxLen ? inputLen - maxLen : 0);
+
+        if (s.diverged)
+            return s.fCost * 100 - s.prefixLen * 300 + lengthDiff * 10;
+
+        // Chưa lệch: từ bên dưới có thể là perfect prefix match, hoặc lệch sau này
+        // với tiền tố chung tối đa inputLen - 1
+        int prefixBound = -10000 + max(0, minLen - inputLen);
+        int otherBound = s.fCost * 100 - (inputLen - 1) * 300;
+        return min(prefixBound, otherBound);
+    }
+
+    // Bộ nhớ tạm của A*, giữ lại theo thread: sau vài lần tìm đầu tiên
+    // mọi vector đã đủ dung lượng nên không còn cấp phát nào nữa
+    struct AStarScratch
+    {
+        vector<AStarState> states;
+        vector<int> heap; // Chỉ số state, min-heap theo (key, f, chỉ số)
+
+        // g tốt nhất cho (vị trí trie, inputPos): bảng băm địa chỉ mở, slot chỉ
+        // hợp lệ khi stamp == generation nên không phải xóa giữa các lần tìm
+        struct Visit
+        {
+            TrieCursor at;
+            uint32_t stamp;
+            short pos;
+            short g;
+        };
+        vector<Visit> visits;
+        size_t visitCount = 0;
+        uint32_t generation = 0;
+
+        vector<pair<int32_t, int>> candidates; // (wordId, điểm tốt nhất)
+        vector<int> scores;
+        string word;      // Từ (chữ thường) dựng lại từ chuỗi parent
+        string candidate; // Từ gốc để đưa vào bộ lọc accept
+
+        void reset()
+        {
+            states.clear();
+            heap.clear();
+            candidates.clear();
+            visitCount = 0;
+            if (visits.empty())
+                visits.resize(1024);
+            if (++generation == 0)
+            {
+                for (auto &v : visits)
+                    v.stamp = 0;
+                generation = 1;
+            }
+        }
+
+        static size_t hashVisit(const TrieCursor &at, int pos)
+        {
+            size_t h = (reinterpret_cast<uintptr_t>(at.node) + at.pending) * 0x9E3779B97F4A7C15ULL;
+            return (h ^ (h >> 29)) + pos * 0x85EBCA6BULL;
+        }
+
+        void growVisits()
+        {
+            vector<Visit> old;
+            old.swap(visits);
+            visits.assign(old.size() * 2, Visit{TrieCursor{}, 0, 0, 0});
+            visitCount = 0;
+            for (const auto &v : old)
+                if (v.stamp == generation)
+                    improves(v.at, v.pos, v.g);
+        }
+
+        // Ghi nhận g cho (vị trí, pos); false nếu đã có g nhỏ hơn hoặc bằng
+        bool improves(const TrieCursor &at, int pos, int g)
+        {
+            if ((visitCount + 1) * 2 > visits.size())
+                growVisits();
+
+            size_t mask = visits.size() - 1;
+            for (size_t i = hashVisit(at, pos) & mask;; i = (i + 1) & mask)
+            {
+                Visit &v = visits[i];
+                if (v.stamp != generation)
+                {
+                    v = {at, generation, (short)pos, (short)g};
+                    visitCount++;
+                    return true;
+                }
+                if (v.at == at && v.pos == pos)
+                {
+                    if (g >= v.g)
+                        return false;
+                    v.g = g;
+                    return true;
+                }
+            }
+        }
+
+        bool heapLess(int a, int b) const
+        {
+            const AStarState &x = states[a], &y = states[b];
+            if (x.key != y.key)
+                return x.key > y.key;
+            if (x.fCost != y.fCost)
+                return x.fCost > y.fCost;
+            return a > b;
+        }
+
+        // Dựng lại từ (chữ thường) của state theo chuỗi parent
+        const string &buildWord(int index)
+        {
+            word.assign(states[index].depth, ' ');
+            for (int i = index; i >= 0; i = states[i].parent)
+                if (states[i].c)
+                    word[states[i].depth - 1] = states[i].c;
+            return word;
+        }
+    };
+}
+
 vector<string> findSimilarWordsAStar(
     TrieNode *root,
+    const StringPool &words,
     const string &word,
     int maxSuggestions,
-    vector<string> (*findWordsWithPrefix)(TrieNode*, const string&, int))
+    const function<bool(const string &)> &accept)
 {
-    if (word.empty() || !root)
+    if (word.empty() || !root || maxSuggestions <= 0)
         return {};
 
-    string normalizedInput;
-    for (char c : word)
-        normalizedInput += tolower(c);
+    static thread_local AStarScratch scratch;
+    static thread_local string normalizedInput;
 
-    priority_queue<AStarState, vector<AStarState>, greater<AStarState>> openSet;
-    
-    unordered_set<string> visited;
-    vector<pair<int, string>> candidates; 
+    normalizedInput.assign(word);
+    for (char &c : normalizedInput)
+        c = tolower(c);
+    const int n = normalizedInput.size();
+    const int maxDistance = maxEditDistanceFor(n);
 
-    int initialH = calculateHeuristic(normalizedInput, 0);
-    openSet.push(AStarState(root, "", 0, 0, initialH));
+    AStarScratch &S = scratch;
+    S.reset();
+    auto heapCmp = [&S](int a, int b) { return S.heapLess(a, b); };
 
-    int maxDistance;
-    if (normalizedInput.size() <= 2)
-        maxDistance = 2;
-    else if (normalizedInput.size() <= 4)
-        maxDistance = 3;
-    else
-        maxDistance = max(3, (int)(normalizedInput.size() * 0.5));
+    auto push = [&](TrieCursor at, int parent, char c, int pos, int depth, int g, int prefixLen, bool diverged)
+    {
+        if (!S.improves(at, pos, g))
+            return;
+        int h = calculateHeuristic(at, normalizedInput, pos);
+        if (g + h > maxDistance)
+            return;
+        AStarState s{at.node, parent, c, diverged, at.pending, (short)pos, (short)depth, (short)prefixLen,
+                     (short)g, (short)h, (short)(g + h), 0};
+        s.key = rankingLowerBound(s, n);
+        S.states.push_back(s);
+        S.heap.push_back(S.states.size() - 1);
+        push_heap(S.heap.begin(), S.heap.end(), heapCmp);
+    };
+
+    // Thêm ký tự c vào đường đi: cập nhật tiền tố chung với input
+    auto extend = [&](int from, char c, TrieCursor child, int pos, int g)
+    {
+        const AStarState &f = S.states[from];
+        int depth = f.depth;
+        bool diverged = f.diverged || depth >= n || normalizedInput[depth] != c;
+        int prefixLen = diverged ? f.prefixLen : min(depth + 1, n);
+        // Đã khớp trọn input: các ký tự thêm vào vẫn giữ perfect prefix match
+        if (!f.diverged && depth >= n)
+            diverged = false;
+        push(child, from, c, pos, depth + 1, g, prefixLen, diverged);
+    };
+
+    int kthBest = INT_MAX;
+
+    push(TrieCursor{root, 0}, -1, 0, 0, 0, 0, 0, false);
 
     int statesExplored = 0;
-    const int MAX_STATES = 10000; 
+    const int MAX_STATES = 50000; // Chốt an toàn; bình thường dừng nhờ cận dưới
 
-    while (!openSet.empty() && statesExplored < MAX_STATES)
+    while (!S.heap.empty() && statesExplored < MAX_STATES)
     {
-        AStarState current = openSet.top();
-        openSet.pop();
+        // Đã có top-k được chứng minh: mọi state còn lại không thể vượt qua
+        if (S.states[S.heap.front()].key > kthBest)
+            break;
+
+        pop_heap(S.heap.begin(), S.heap.end(), heapCmp);
+        int index = S.heap.back();
+        S.heap.pop_back();
         statesExplored++;
 
-        // Kiểm tra nếu đã tìm đủ suggestions
-        if (candidates.size() >= (size_t)(maxSuggestions * 3)) 
+        // Sao chép: S.states có thể cấp phát lại khi push
+        AStarState current = S.states[index];
+        TrieCursor at{current.node, current.pending};
+        TrieNode *node = current.node;
+        int pos = current.inputPos;
+
+        if (at.isEnd() && pos == n && current.gCost <= maxDistance)
         {
-            if (!candidates.empty())
+            int score = calculateRankingScore(normalizedInput, S.buildWord(index), current.gCost);
+
+            auto found = find_if(S.candidates.begin(), S.candidates.end(),
+                                 [&](const pair<int32_t, int> &e) { return e.first == node->wordId; });
+
+            bool accepted;
+            if (found != S.candidates.end())
+            {
+                accepted = score < found->second;
+                if (accepted)
+                    found->second = score;
+            }
+            else
+            {
+                // Bộ lọc (vd. chỉ các symbol còn nhìn thấy) áp dụng trước khi xếp hạng
+                if (accept)
+                {
+                    string_view original = words.view(node->wordId);
+                    S.candidate.assign(original.data(), original.size());
+                }
+                accepted = !accept || accept(S.candidate);
+                if (accepted)
+                    S.candidates.push_back({node->wordId, score});
+            }
+
+            if (accepted && (int)S.candidates.size() >= maxSuggestions)
             {
-                int worstScore = candidates.back().first;
-                if (current.fCost * 100 > worstScore + 5000)
-                    break;
+                S.scores.clear();
+                for (auto &e : S.candidates)
+                    S.scores.push_back(e.second);
+                nth_element(S.scores.begin(), S.scores.begin() + (maxSuggestions - 1), S.scores.end());
+                kthBest = S.scores[maxSuggestions - 1];
             }
         }
 
-        if (current.node->isEnd)
+        // 1. Match / 2. Substitution: tiến cả input và trie
+        if (pos < n)
         {
-            string candidateWord = current.node->originalWord.empty()
-                                       ? current.currentWord
-                                       : current.node->originalWord;
+            char inputChar = normalizedInput[pos];
+            at.forEachNext([&](char c, TrieCursor child)
+                           { extend(index, c, child, pos + 1, current.gCost + (c == inputChar ? 0 : 1)); });
+        }
+
+        // 3. Insertion: thêm ký tự vào candidate (không tiến input)
+        at.forEachNext([&](char c, TrieCursor child)
+                       { extend(index, c, child, pos, current.gCost + 1); });
+
+        // 4. Deletion: bỏ qua ký tự input (tiến input, không tiến trie)
+        if (pos < n)
+            push(at, index, 0, pos + 1, current.depth, current.gCost + 1, current.prefixLen, current.diverged);
+    }
 
-            int actualDistance = calculateEditDistance(normalizedInput, current.currentWord);
+    sort(S.candidates.begin(), S.candidates.end(),
+         [&](const pair<int32_t, int> &a, const pair<int32_t, int> &b)
+         {
+             if (a.second != b.second)
+                 return a.second < b.second;
+             return words.view(a.first) < words.view(b.first);
+         });
+
+    // Lấy top suggestions
+    vector<string> result;
+    for (int i = 0; i < min(maxSuggestions, (int)S.candidates.size()); i++)
+    {
+        result.push_back(words.get(S.candidates[i].first));
+    }
 
-            if (actualDistance <= maxDistance && visited.find(candidateWord) == visited.end())
+    return result;
+}
+
+namespace
+{
+    // Trạng thái dùng chung cho một lần duyệt DFS + DP
+    struct LevenshteinWalk
+    {
+        const StringPool &words;
+        const string &input;
+        const function<bool(const string &)> &accept;
+        int maxDistance;
+        int width;               // input.size() + 1
+        vector<int> rows;        // Hàng DP của từng tầng, nối liền nhau
+        string path;             // Các ký tự (đã hạ chữ thường) từ gốc tới node
+        vector<pair<int, string>> candidates;
+
+        void visit(TrieNode *node, int depth)
+        {
+            const int *row = &rows[depth * width];
+
+            // Ô cuối hàng là khoảng cách chính xác của từ kết thúc tại node
+            if (node->isEnd() && row[width - 1] <= maxDistance)
             {
-                visited.insert(candidateWord);
-                int score = calculateRankingScore(normalizedInput, current.currentWord);
-                candidates.push_back({score, candidateWord});
+                string candidateWord = words.get(node->wordId);
+                if (!accept || accept(candidateWord))
+                    candidates.push_back({calculateRankingScore(input, path, row[width - 1]), candidateWord});
+            }
+
+            // Cạnh nén: ký tự khóa rồi từng ký tự của nhãn, mỗi ký tự một hàng DP
+            for (auto [c, child] : node->children)
+            {
+                size_t base = path.size();
+                int end = depth;
+                bool alive = step(end++, c);
+                for (int k = 0; alive && k < child->labelLength; k++)
+                    alive = step(end++, child->label[k]);
+
+                if (alive)
+                {
+                    path.push_back(c);
+                    path.append(child->label, child->labelLength);
+                    visit(child, end);
+                }
+                path.resize(base);
             }
         }
 
-        if (current.gCost > maxDistance + 2)
-            continue;
+        // Hàng DP của tầng depth + 1 sau ký tự c; false nếu cả nhánh vượt ngưỡng
+        bool step(int depth, char c)
+        {
+            if ((size_t)(depth + 2) * width > rows.size())
+                rows.resize((depth + 2) * width);
+
+            const int *prev = &rows[depth * width];
+            int *curr = &rows[(depth + 1) * width];
+
+            curr[0] = prev[0] + 1;
+            int rowMin = curr[0];
+            for (int j = 1; j < width; j++)
+            {
+                int cost = (input[j - 1] == c) ? 0 : 1;
+                curr[j] = min({prev[j] + 1, curr[j - 1] + 1, prev[j - 1] + cost});
+                rowMin = min(rowMin, curr[j]);
+            }
+
+            // Mọi từ trong nhánh con đều có khoảng cách >= rowMin
+            return rowMin <= maxDistance;
+        }
+    };
+}
+
+vector<string> findSimilarWordsLevenshtein(
+    TrieNode *root,
+    const StringPool &words,
+    const string &word,
+    int maxSuggestions,
+    const function<bool(const string &)> &accept)
+{
+    if (word.empty() || !root)
+        return {};
+
+    string normalizedInput;
+    for (char c : word)
+        normalizedInput += tolower(c);
+
+    LevenshteinWalk walk{words, normalizedInput, accept, maxEditDistanceFor(normalizedInput.size()),
+                         (int)normalizedInput.size() + 1, {}, {}, {}};
+
+    walk.rows.resize(walk.width * (normalizedInput.size() + walk.maxDistance + 2));
+    for (int j = 0; j < walk.width; j++)
+        walk.rows[j] = j;
 
+    walk.visit(root, 0);
 
-        // 1. Match: tiến cả input và trie
-        if (current.inputPos < (int)normalizedInput.size())
+    sort(walk.candidates.begin(), walk.candidates.end());
+
+    vector<string> result;
+    for (int i = 0; i < min(maxSuggestions, (int)walk.candidates.size()); i++)
+        result.push_back(walk.candidates[i].second);
+
+    return result;
+}
+
+namespace
+{
+    struct AutomatonWalk
+    {
+        const StringPool &words;
+        const string &input;
+        const function<bool(const string &)> &accept;
+        const LevenshteinAutomaton &automaton;
+        int stateSize;
+        vector<uint64_t> states; // Trạng thái của từng tầng, nối liền nhau
+        string path;
+        vector<pair<int, string>> candidates;
+
+        void visit(TrieNode *node, int depth)
         {
-            char inputChar = normalizedInput[current.inputPos];
+            const uint64_t *state = &states[depth * stateSize];
 
-            if (current.node->children.count(inputChar))
+            int distance = automaton.distance(state);
+            if (node->isEnd() && distance >= 0)
             {
-                TrieNode *nextNode = current.node->children[inputChar];
-                string nextWord = current.currentWord + inputChar;
-                int nextPos = current.inputPos + 1;
-                int g = current.gCost; // Không tốn chi phí khi match
-                int h = calculateHeuristic(normalizedInput, nextPos);
+                string candidateWord = words.get(node->wordId);
+                if (!accept || accept(candidateWord))
+                    candidates.push_back({calculateRankingScore(input, path, distance), candidateWord});
+            }
 
-                openSet.push(AStarState(nextNode, nextWord, nextPos, g, h));
+            // Cạnh nén: automaton bước qua ký tự khóa rồi từng ký tự của nhãn
+            for (auto [c, child] : node->children)
+            {
+                int end = depth;
+                bool alive = step(end++, c);
+                for (int k = 0; alive && k < child->labelLength; k++)
+                    alive = step(end++, child->label[k]);
+                if (!alive)
+                    continue;
+
+                size_t base = path.size();
+                path.push_back(c);
+                path.append(child->label, child->labelLength);
+                visit(child, end);
+                path.resize(base);
             }
         }
 
-        // 2. Substitution: thay thế ký tự
-        if (current.inputPos < (int)normalizedInput.size())
+        bool step(int depth, char c)
         {
-            for (auto &[c, child] : current.node->children)
+            if ((size_t)(depth + 2) * stateSize > states.size())
+                states.resize((depth + 2) * stateSize);
+            return automaton.step(&states[depth * stateSize], (unsigned char)c, &states[(depth + 1) * stateSize]);
+        }
+    };
+}
+
+vector<string> findSimilarWordsAutomaton(
+    TrieNode *root,
+    const StringPool &words,
+    const string &word,
+    int maxSuggestions,
+    const function<bool(const string &)> &accept)
+{
+    if (word.empty() || !root)
+        return {};
+    if (word.size() > LevenshteinAutomaton::MAX_PATTERN)
+        return findSimilarWordsLevenshtein(root, words, word, maxSuggestions, accept);
+
+    string normalizedInput;
+    for (char c : word)
+        normalizedInput += tolower(c);
+
+    int maxDistance = maxEditDistanceFor(normalizedInput.size());
+    LevenshteinAutomaton automaton(normalizedInput, maxDistance);
+
+    AutomatonWalk walk{words, normalizedInput, accept, automaton, automaton.stateSize(), {}, {}, {}};
+    walk.states.resize(walk.stateSize * (normalizedInput.size() + maxDistance + 2));
+    automaton.start(walk.states.data());
+
+    walk.visit(root, 0);
+
+    sort(walk.candidates.begin(), walk.candidates.end());
+
+    vector<string> result;
+    for (int i = 0; i < min(maxSuggestions, (int)walk.candidates.size()); i++)
+        result.push_back(walk.candidates[i].second);
+
+    return result;
+}
+
+vector<string> findSimilarWordsSymSpell(
+    TrieNode *root,
+    const StringPool &words,
+    const SymSpellIndex &index,
+    const string &word,
+    int maxSuggestions,
+    const function<bool(const string &)> &accept)
+{
+    if (word.empty() || !root || maxSuggestions <= 0)
+        return {};
+
+    string normalizedInput;
+    for (char c : word)
+        normalizedInput += tolower(c);
+    const int n = normalizedInput.size();
+
+    // 1. Lỗi gõ: vài lần tra bảng băm, ứng viên đã được kiểm tra khoảng cách
+    vector<pair<uint32_t, int>> hits;
+    index.lookup(normalizedInput, maxEditDistanceFor(n), words, hits);
+
+    vector<pair<int, string>> candidates;
+    vector<uint32_t> seenIds;
+    for (auto [id, distance] : hits)
+    {
+        seenIds.push_back(id);
+        string candidateWord = words.get(id);
+        if (!accept || accept(candidateWord))
+            candidates.push_back({calculateRankingScore(normalizedInput, candidateWord, distance), candidateWord});
+    }
+    sort(seenIds.begin(), seenIds.end());
+
+    // 2. Perfect prefix match: duyệt theo tầng dưới node của input, dừng khi
+    // một tầng đã đủ số gợi ý (các tầng sâu hơn chỉ có điểm kém hơn)
+    TrieCursor at{root, 0};
+    for (char c : normalizedInput)
+    {
+        at = at.next(c);
+        if (!at.valid())
+            break;
+    }
+
+    vector<TrieCursor> level, next;
+    if (at.valid())
+        level.push_back(at);
+
+    int prefixMatches = 0;
+    for (int depth = n; !level.empty() && prefixMatches < maxSuggestions; depth++)
+    {
+        next.clear();
+        for (const TrieCursor &current : level)
+        {
+            if (current.isEnd() && !binary_search(seenIds.begin(), seenIds.end(), (uint32_t)current.node->wordId))
             {
-                if (c != normalizedInput[current.inputPos])
+                string candidateWord = words.get(current.node->wordId);
+                if (!accept || accept(candidateWord))
                 {
-                    string nextWord = current.currentWord + c;
-                    int nextPos = current.inputPos + 1;
-                    int g = current.gCost + 1; // Chi phí thay thế
-                    int h = calculateHeuristic(normalizedInput, nextPos);
-
-                    if (g <= maxDistance) 
-                        openSet.push(AStarState(child, nextWord, nextPos, g, h));
+                    candidates.push_back({-10000 + (depth - n), candidateWord});
+                    prefixMatches++;
                 }
             }
+            current.forEachNext([&](char, TrieCursor child)
+                                { next.push_back(child); });
         }
+        level.swap(next);
+    }
 
-        // 3. Insertion: thêm ký tự vào candidate (không tiến input)
-        for (auto &[c, child] : current.node->children)
+    sort(candidates.begin(), candidates.end());
+
+    vector<string> result;
+    for (int i = 0; i < min(maxSuggestions, (int)candidates.size()); i++)
+        result.push_back(candidates[i].second);
+
+    return result;
+}
+
+namespace
+{
+    struct BatchQuery
+    {
+        string input; // Chữ thường
+        LevenshteinAutomaton automaton;
+        int stateSize;
+        vector<uint64_t> states; // Trạng thái của từng tầng, nối liền nhau
+        vector<pair<int, string>> candidates;
+
+        BatchQuery(const string &normalizedInput)
+            : input(normalizedInput),
+              automaton(normalizedInput, maxEditDistanceFor(normalizedInput.size())),
+              stateSize(automaton.stateSize())
+        {
+            states.resize(stateSize * (input.size() + maxEditDistanceFor(input.size()) + 2));
+            automaton.start(states.data());
+        }
+    };
+
+    struct BatchWalk
+    {
+        const StringPool &words;
+        vector<BatchQuery> &queries;
+        const vector<size_t> &queryIndex; // Vị trí trong lô gốc (truyền cho accept)
+        const function<bool(size_t, const string &)> &accept;
+        vector<vector<int>> active; // active[d]: truy vấn còn sống ở tầng d
+        string path;
+
+        void visit(TrieNode *node, int depth)
         {
-            string nextWord = current.currentWord + c;
-            int g = current.gCost + 1;
-            int h = calculateHeuristic(normalizedInput, current.inputPos);
+            if (active.size() < (size_t)depth + 2)
+                active.resize(depth + 2);
+
+            if (node->isEnd())
+            {
+                string candidateWord;
+                for (int q : active[depth])
+                {
+                    BatchQuery &query = queries[q];
+                    int distance = query.automaton.distance(&query.states[depth * query.stateSize]);
+                    if (distance < 0)
+                        continue;
+                    if (candidateWord.empty())
+                        candidateWord = words.get(node->wordId);
+                    if (!accept || accept(queryIndex[q], candidateWord))
+                        query.candidates.push_back({calculateRankingScore(query.input, path, distance), candidateWord});
+                }
+            }
 
-            if (g <= maxDistance && nextWord.size() <= normalizedInput.size() + maxDistance)
-                openSet.push(AStarState(child, nextWord, current.inputPos, g, h));
+            // Cạnh nén: bước qua ký tự khóa rồi từng ký tự của nhãn
+            for (auto [c, child] : node->children)
+            {
+                int end = depth;
+                bool alive = step(end++, c);
+                for (int k = 0; alive && k < child->labelLength; k++)
+                    alive = step(end++, child->label[k]);
+                if (!alive)
+                    continue;
+
+                size_t base = path.size();
+                path.push_back(c);
+                path.append(child->label, child->labelLength);
+                visit(child, end);
+                path.resize(base);
+            }
         }
 
-        // 4. Deletion: bỏ qua ký tự input (tiến input, không tiến trie)
-        if (current.inputPos < (int)normalizedInput.size())
+        // active[depth + 1] = các truy vấn còn sống sau ký tự c; false nếu không còn truy vấn nào.
+        // active có thể được mở rộng khi đệ quy: truy cập theo chỉ số, không giữ tham chiếu
+        bool step(int depth, char c)
+        {
+            if (active.size() < (size_t)depth + 2)
+                active.resize(depth + 2);
+            active[depth + 1].clear();
+            for (int q : active[depth])
+            {
+                BatchQuery &query = queries[q];
+                if ((size_t)(depth + 2) * query.stateSize > query.states.size())
+                    query.states.resize((depth + 2) * query.stateSize);
+                if (query.automaton.step(&query.states[depth * query.stateSize], (unsigned char)c,
+                                         &query.states[(depth + 1) * query.stateSize]))
+                    active[depth + 1].push_back(q);
+            }
+            return !active[depth + 1].empty();
+        }
+    };
+
+    // Một lần duyệt cho các truy vấn [begin, end) của lô
+    void runBatch(TrieNode *root, const StringPool &words, const vector<string> &queries,
+                  size_t begin, size_t end, int maxSuggestions,
+                  const function<bool(size_t, const string &)> &accept,
+                  vector<vector<string>> &results)
+    {
+        vector<BatchQuery> shared;
+        vector<size_t> queryIndex;
+        for (size_t i = begin; i < end; i++)
         {
-            int g = current.gCost + 1;
-            int h = calculateHeuristic(normalizedInput, current.inputPos + 1);
+            if (queries[i].empty())
+                continue;
+            if (queries[i].size() > LevenshteinAutomaton::MAX_PATTERN)
+            {
+                // Quá dài cho automaton: tìm riêng như findSimilarWordsAutomaton
+                results[i] = findSimilarWordsLevenshtein(
+                    root, words, queries[i], maxSuggestions,
+                    [&](const string &candidate) { return !accept || accept(i, candidate); });
+                continue;
+            }
 
-            if (g <= maxDistance)
-                openSet.push(AStarState(current.node, current.currentWord, current.inputPos + 1, g, h));
+            string normalizedInput;
+            for (char c : queries[i])
+                normalizedInput += tolower(c);
+            shared.emplace_back(normalizedInput);
+            queryIndex.push_back(i);
+        }
+        if (shared.empty())
+            return;
+
+        BatchWalk walk{words, shared, queryIndex, accept, {}, {}};
+        walk.active.resize(2);
+        for (size_t q = 0; q < shared.size(); q++)
+            walk.active[0].push_back(q);
+        walk.visit(root, 0);
+
+        for (size_t q = 0; q < shared.size(); q++)
+        {
+            auto &candidates = shared[q].candidates;
+            sort(candidates.begin(), candidates.end());
+            vector<string> &result = results[queryIndex[q]];
+            for (int i = 0; i < min(maxSuggestions, (int)candidates.size()); i++)
+                result.push_back(candidates[i].second);
         }
     }
+}
 
-    // Sắp xếp candidates theo score
-    sort(candidates.begin(), candidates.end());
+vector<vector<string>> findSimilarWordsBatch(
+    TrieNode *root,
+    const StringPool &words,
+    const vector<string> &queries,
+    int maxSuggestions,
+    const function<bool(size_t, const string &)> &accept,
+    int threads)
+{
+    vector<vector<string>> results(queries.size());
+    if (!root || queries.empty() || maxSuggestions <= 0)
+        return results;
 
-    // Lấy top suggestions
-    vector<string> result;
-    for (int i = 0; i < min(maxSuggestions, (int)candidates.size()); i++)
+    // Mỗi luồng ghi vào các phần tử results riêng của đoạn mình
+    size_t chunks = max<size_t>(1, min<size_t>(threads, queries.size()));
+    if (chunks == 1)
     {
-        result.push_back(candidates[i].second);
+        runBatch(root, words, queries, 0, queries.size(), maxSuggestions, accept, results);
+        return results;
     }
 
-    return result;
+    vector<thread> workers;
+    size_t per = (queries.size() + chunks - 1) / chunks;
+    for (size_t begin = 0; begin < queries.size(); begin += per)
+    {
+        size_t end = min(queries.size(), begin + per);
+        workers.emplace_back([&, begin, end]
+                             { runBatch(root, words, queries, begin, end, maxSuggestions, accept, results); });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    return results;
 }
@@ -3,36 +3,101 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <functional>
 
 using namespace std;
 
 struct TrieNode;
+struct TrieCursor;
+class StringPool;
+class SymSpellIndex;
 
-// State cho A* search
-struct AStarState
+// Engine tìm kiếm gần đúng trên Trie
+enum class FuzzyEngine
 {
-    TrieNode *node;     // Node hiện tại trong Trie
-    string currentWord; // Từ đang xây dựng
-    int inputPos;       // Vị trí trong input word
-    int gCost;          // Chi phí thực tế (số thao tác đã thực hiện)
-    int hCost;          // Chi phí ước lượng (heuristic)
-    int fCost;          // Tổng chi phí f = g + h
-
-    AStarState(TrieNode *n, string word, int pos, int g, int h);
+    AStar,       // A* trên không gian (node, vị trí input)
+    Levenshtein, // DFS mang theo một hàng DP mỗi tầng, cắt nhánh theo ngưỡng
+    Automaton,   // Giao Trie với automaton Damerau-Levenshtein dựng cho truy vấn
+    SymSpell     // Tra chỉ mục biến thể xóa (khoảng cách <= 2) + completion theo tiền tố
+};
 
-    bool operator>(const AStarState &other) const;
+// State cho A* search: (vị trí trong Trie, vị trí trong input). Các state nằm
+// trong một mảng dùng lại giữa các lần tìm; từ đang xây dựng không được lưu mà
+// dựng lại theo chuỗi parent khi cần.
+struct AStarState
+{
+    TrieNode *node;    // Node hiện tại trong Trie (cuối cạnh đang đi)
+    int parent;        // Chỉ số state cha (-1 ở gốc)
+    char c;            // Ký tự thêm vào từ ở bước này (0 nếu là phép xóa)
+    bool diverged;     // Từ đang xây đã lệch khỏi input (prefixLen cố định)
+    unsigned char pending; // Số ký tự nhãn còn lại trước khi tới node (xem TrieCursor)
+    short inputPos;    // Vị trí trong input word
+    short depth;       // Độ dài từ đang xây
+    short prefixLen;   // Tiền tố chung của từ đang xây với input
+    short gCost;       // Chi phí thực tế (số thao tác đã thực hiện)
+    short hCost;       // Chi phí ước lượng (heuristic, không vượt quá chi phí thật)
+    short fCost;       // Tổng chi phí f = g + h
+    int key;           // Cận dưới ranking score của mọi từ đi qua state này
 };
 
-int calculateHeuristic(const string &input, int inputPos);
+// Heuristic chấp nhận được: cận dưới số thao tác còn cần từ (vị trí, inputPos),
+// dựa trên độ dài còn lại của cây con và các ký tự input không có bên dưới
+int calculateHeuristic(const TrieCursor &at, const string &input, int inputPos);
 
 int calculateEditDistance(const string &input, const string &candidate);
 
 int calculateRankingScore(const string &input, const string &candidate);
+// Như trên nhưng dùng khoảng cách đã tính sẵn
+int calculateRankingScore(const string &input, const string &candidate, int distance);
+
+// Ngưỡng khoảng cách chỉnh sửa cho phép theo độ dài input
+int maxEditDistanceFor(size_t inputLength);
 
 vector<string> findSimilarWordsAStar(
     TrieNode *root,
+    const StringPool &words,
+    const string &word,
+    int maxSuggestions,
+    const function<bool(const string &)> &accept = nullptr);
+
+vector<string> findSimilarWordsLevenshtein(
+    TrieNode *root,
+    const StringPool &words,
+    const string &word,
+    int maxSuggestions,
+    const function<bool(const string &)> &accept = nullptr);
+
+// Hoán vị hai ký tự kề nhau (vd. 'pirntf' -> 'printf') chỉ tính 1 lỗi.
+// Pattern dài hơn LevenshteinAutomaton::MAX_PATTERN dùng engine Levenshtein.
+vector<string> findSimilarWordsAutomaton(
+    TrieNode *root,
+    const StringPool &words,
     const string &word,
     int maxSuggestions,
-    vector<string> (*findWordsWithPrefix)(TrieNode *, const string &, int));
-    
+    const function<bool(const string &)> &accept = nullptr);
+
+// Lỗi gõ tìm qua chỉ mục xóa đối xứng nên chỉ tới khoảng cách
+// SymSpellIndex::MAX_DISTANCE; các từ nhận input làm tiền tố lấy từ trie
+// theo chiều rộng (ngắn nhất trước), xếp hạng chung bằng calculateRankingScore.
+vector<string> findSimilarWordsSymSpell(
+    TrieNode *root,
+    const StringPool &words,
+    const SymSpellIndex &index,
+    const string &word,
+    int maxSuggestions,
+    const function<bool(const string &)> &accept = nullptr);
+
+// Nhiều truy vấn trên cùng một lần duyệt trie: mỗi truy vấn mang trạng thái
+// automaton riêng, nhánh chỉ bị cắt khi mọi truy vấn đều chết nên các tầng
+// trên được duyệt một lần cho cả lô. Kết quả từng truy vấn giống hệt
+// findSimilarWordsAutomaton. accept nhận chỉ số truy vấn; threads > 1 chia lô
+// thành các đoạn liên tiếp chạy song song (kết quả không phụ thuộc số luồng).
+vector<vector<string>> findSimilarWordsBatch(
+    TrieNode *root,
+    const StringPool &words,
+    const vector<string> &queries,
+    int maxSuggestions,
+    const function<bool(size_t, const string &)> &accept = nullptr,
+    int threads = 1);
+
 #endif // FUZZY_SEARCH_H
\ No newline at end of file
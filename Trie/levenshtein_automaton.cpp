@@ -0,0 +1,71 @@
+#include "levenshtein_automaton.h"
+#include <cctype>
+#include <cstring>
+
+LevenshteinAutomaton::LevenshteinAutomaton(const string &pattern, int maxDistance, bool transpositions)
+    : m(pattern.size()), k(maxDistance), transpositions(transpositions)
+{
+    mask = (m + 1 >= 64) ? ~0ULL : ((1ULL << (m + 1)) - 1);
+    memset(B, 0, sizeof(B));
+    for (size_t i = 0; i < m; i++)
+    {
+        unsigned char c = pattern[i];
+        B[(unsigned char)tolower(c)] |= 1ULL << (i + 1);
+        B[(unsigned char)toupper(c)] |= 1ULL << (i + 1);
+    }
+}
+
+void LevenshteinAutomaton::start(uint64_t *state) const
+{
+    uint64_t *R = state;
+    uint64_t *T = state + k + 1;
+    for (int d = 0; d <= k; d++)
+    {
+        // Bỏ qua d ký tự đầu của pattern (xóa) tốn d lỗi
+        R[d] = (d + 1 >= 64 ? ~0ULL : ((1ULL << (d + 1)) - 1)) & mask;
+        T[d] = 0;
+    }
+}
+
+bool LevenshteinAutomaton::step(const uint64_t *from, unsigned char c, uint64_t *to) const
+{
+    const uint64_t *R = from;
+    const uint64_t *T = from + k + 1;
+    uint64_t *nR = to;
+    uint64_t *nT = to + k + 1;
+    uint64_t eq = B[c];
+    uint64_t alive = 0;
+
+    nR[0] = (R[0] << 1) & eq;
+    nT[0] = 0;
+    alive |= nR[0];
+
+    for (int d = 1; d <= k; d++)
+    {
+        uint64_t r = ((R[d] << 1) & eq)   // Khớp
+                     | R[d - 1]            // Chèn ký tự vào từ
+                     | (R[d - 1] << 1)     // Thay thế
+                     | (nR[d - 1] << 1);   // Xóa ký tự pattern
+        if (transpositions)
+        {
+            r |= T[d] & (eq << 1);               // Hoàn tất hoán vị
+            nT[d] = ((R[d - 1] << 2) & eq) & mask; // Ký tự hiện tại khớp pattern[i + 1]
+        }
+        else
+        {
+            nT[d] = 0;
+        }
+        nR[d] = r & mask;
+        alive |= nR[d] | nT[d];
+    }
+    return alive != 0;
+}
+
+int LevenshteinAutomaton::distance(const uint64_t *state) const
+{
+    uint64_t acceptBit = 1ULL << m;
+    for (int d = 0; d <= k; d++)
+        if (state[d] & acceptBit)
+            return d;
+    return -1;
+}
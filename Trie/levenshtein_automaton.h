@@ -0,0 +1,37 @@
+#ifndef LEVENSHTEIN_AUTOMATON_H
+#define LEVENSHTEIN_AUTOMATON_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Automaton Levenshtein (tùy chọn Damerau: hoán vị hai ký tự kề nhau tính 1 lỗi)
+// dựng một lần cho mỗi truy vấn, mô phỏng bit-parallel kiểu Wu-Manber.
+// Trạng thái gồm 2 * (k + 1) word: R[d] - bit i bật nếu i ký tự đầu của pattern
+// đã khớp với <= d lỗi; T[d] - đang giữa một phép hoán vị.
+// Giao với Trie: mỗi cạnh là một lần step(), nhánh chết (mọi bit tắt) bị cắt,
+// nên chi phí phụ thuộc ngưỡng k chứ không phụ thuộc kích thước từ điển.
+class LevenshteinAutomaton
+{
+    size_t m;
+    int k;
+    bool transpositions;
+    uint64_t mask;    // Bit 0..m
+    uint64_t B[256];  // B[c]: bit i + 1 bật nếu pattern[i] == c (không phân biệt hoa thường)
+
+public:
+    static constexpr size_t MAX_PATTERN = 62;
+
+    LevenshteinAutomaton(const string &pattern, int maxDistance, bool transpositions = true);
+
+    int stateSize() const { return 2 * (k + 1); }
+    void start(uint64_t *state) const;
+    // Chuyển trạng thái theo ký tự c; trả về false nếu automaton đã chết
+    bool step(const uint64_t *from, unsigned char c, uint64_t *to) const;
+    // Khoảng cách nhỏ nhất nếu trạng thái chấp nhận, ngược lại -1
+    int distance(const uint64_t *state) const;
+};
+
+#endif // LEVENSHTEIN_AUTOMATON_H
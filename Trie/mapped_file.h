@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+// Ánh xạ một file vào bộ nhớ, chỉ đọc (mmap / MapViewOfFile). Trang chỉ được
+// nạp khi truy cập lần đầu nên mở file lớn gần như tức thì.
+class MappedFile
+{
+    const char *base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const string &path);
+    void close();
+
+    const char *data() const { return base; }
+    size_t size() const { return length; }
+    bool isOpen() const { return base != nullptr; }
+};
+
+#endif // MAPPED_FILE_H
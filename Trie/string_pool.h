@@ -0,0 +1,43 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Kho chuỗi dùng chung: mọi từ nằm liên tiếp trong một buffer,
+// truy cập bằng ID thay vì mỗi node giữ một std::string riêng
+class StringPool
+{
+    string chars;
+    vector<uint32_t> offsets{0}; // Từ i nằm trong [offsets[i], offsets[i + 1])
+
+public:
+    uint32_t add(string_view s)
+    {
+        chars.append(s.data(), s.size());
+        offsets.push_back(chars.size());
+        return offsets.size() - 2;
+    }
+
+    string_view view(uint32_t id) const
+    {
+        return string_view(chars.data() + offsets[id], offsets[id + 1] - offsets[id]);
+    }
+
+    string get(uint32_t id) const { return string(view(id)); }
+
+    size_t size() const { return offsets.size() - 1; }
+    size_t bytes() const { return chars.capacity() + offsets.capacity() * sizeof(uint32_t); }
+
+    void clear()
+    {
+        chars.clear();
+        offsets.assign(1, 0);
+    }
+};
+
+#endif // STRING_POOL_H
@@ -0,0 +1,194 @@
+#include "symspell.h"
+#include "string_pool.h"
+#include "edit_distance.h"
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+    // FNV-1a trên chữ thường, bỏ qua hai vị trí skipA, skipB
+    uint64_t hashSkipping(string_view word, size_t skipA, size_t skipB)
+    {
+        uint64_t h = 1469598103934665603ULL;
+        for (size_t i = 0; i < word.size(); i++)
+        {
+            if (i == skipA || i == skipB)
+                continue;
+            h ^= (unsigned char)tolower(word[i]);
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    uint64_t mixHash(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        return h;
+    }
+}
+
+void SymSpellIndex::deleteVariants(string_view word, int maxDeletes, vector<uint64_t> &out)
+{
+    const size_t none = string_view::npos;
+    size_t n = word.size();
+
+    out.push_back(hashSkipping(word, none, none));
+    if (maxDeletes >= 1)
+    {
+        for (size_t i = 0; i < n; i++)
+            out.push_back(hashSkipping(word, i, none));
+    }
+    if (maxDeletes >= 2)
+    {
+        for (size_t i = 0; i < n; i++)
+            for (size_t j = i + 1; j < n; j++)
+                out.push_back(hashSkipping(word, i, j));
+    }
+
+}
+
+void SymSpellIndex::growSlots()
+{
+    vector<Slot> old;
+    old.swap(slots);
+    slots.assign(old.empty() ? 1024 : old.size() * 2, Slot{0, EMPTY});
+    for (const Slot &s : old)
+    {
+        if (s.head != EMPTY)
+            slotFor(s.hash) = s;
+    }
+}
+
+SymSpellIndex::Slot &SymSpellIndex::slotFor(uint64_t hash)
+{
+    size_t mask = slots.size() - 1;
+    for (size_t i = mixHash(hash) & mask;; i = (i + 1) & mask)
+    {
+        if (slots[i].head == EMPTY || slots[i].hash == hash)
+            return slots[i];
+    }
+}
+
+const SymSpellIndex::Slot *SymSpellIndex::findSlot(uint64_t hash) const
+{
+    if (slots.empty())
+        return nullptr;
+    size_t mask = slots.size() - 1;
+    for (size_t i = mixHash(hash) & mask;; i = (i + 1) & mask)
+    {
+        if (slots[i].head == EMPTY)
+            return nullptr;
+        if (slots[i].hash == hash)
+            return &slots[i];
+    }
+}
+
+void SymSpellIndex::add(uint32_t wordId, string_view word)
+{
+    static thread_local vector<uint64_t> variants;
+    variants.clear();
+    deleteVariants(word.substr(0, PREFIX_LENGTH), MAX_DISTANCE, variants);
+    // Ký tự lặp (vd. "ll") cho cùng một biến thể
+    sort(variants.begin(), variants.end());
+    variants.erase(unique(variants.begin(), variants.end()), variants.end());
+
+    for (uint64_t h : variants)
+    {
+        if ((used + 1) * 4 > slots.size() * 3)
+            growSlots();
+
+        Slot &slot = slotFor(h);
+        if (slot.head == EMPTY)
+        {
+            slot.hash = h;
+            used++;
+        }
+        postings.push_back({wordId, slot.head});
+        slot.head = postings.size() - 1;
+    }
+}
+
+void SymSpellIndex::replace(uint32_t oldId, uint32_t newId, string_view word)
+{
+    static thread_local vector<uint64_t> variants;
+    variants.clear();
+    deleteVariants(word.substr(0, PREFIX_LENGTH), MAX_DISTANCE, variants);
+
+    for (uint64_t h : variants)
+    {
+        const Slot *slot = findSlot(h);
+        for (uint32_t p = slot ? slot->head : EMPTY; p != EMPTY; p = postings[p].next)
+        {
+            if (postings[p].wordId == oldId)
+                postings[p].wordId = newId;
+        }
+    }
+}
+
+void SymSpellIndex::lookup(const string &input, int maxDistance, const StringPool &words,
+                           vector<pair<uint32_t, int>> &out) const
+{
+    out.clear();
+    if (input.empty() || slots.empty())
+        return;
+    maxDistance = min(maxDistance, MAX_DISTANCE);
+
+    // Bộ nhớ tạm theo thread: stamp theo thế hệ để khử trùng ứng viên mà không phải xóa
+    static thread_local vector<uint64_t> variants;
+    static thread_local vector<uint32_t> seen;
+    static thread_local uint32_t generation = 0;
+    static thread_local string candidate;
+
+    if (seen.size() < words.size())
+        seen.resize(words.size(), 0);
+    if (++generation == 0)
+    {
+        fill(seen.begin(), seen.end(), 0);
+        generation = 1;
+    }
+
+    EditDistancePattern pattern(input);
+
+    // Tiền tố PREFIX_LENGTH của từ khớp với một tiền tố độ dài m của input,
+    // m lệch tối đa maxDistance (hoặc cả input nếu input ngắn hơn)
+    size_t n = input.size();
+    size_t from = min(n, PREFIX_LENGTH - maxDistance);
+    size_t to = min(n, PREFIX_LENGTH + maxDistance);
+    variants.clear();
+    for (size_t m = from; m <= to; m++)
+        deleteVariants(string_view(input).substr(0, m), maxDistance, variants);
+    sort(variants.begin(), variants.end());
+    variants.erase(unique(variants.begin(), variants.end()), variants.end());
+
+    for (uint64_t h : variants)
+    {
+        const Slot *slot = findSlot(h);
+        for (uint32_t p = slot ? slot->head : EMPTY; p != EMPTY; p = postings[p].next)
+        {
+            uint32_t id = postings[p].wordId;
+            if (id == EMPTY || seen[id] == generation)
+                continue;
+            seen[id] = generation;
+
+            // Độ dài chênh quá ngưỡng thì không cần tính khoảng cách
+            string_view word = words.view(id);
+            if ((int)word.size() - (int)input.size() > maxDistance ||
+                (int)input.size() - (int)word.size() > maxDistance)
+                continue;
+
+            candidate.assign(word.data(), word.size());
+            int distance = pattern.distanceTo(candidate);
+            if (distance <= maxDistance)
+                out.push_back({id, distance});
+        }
+    }
+}
+
+void SymSpellIndex::clear()
+{
+    slots.clear();
+    used = 0;
+    postings.clear();
+}
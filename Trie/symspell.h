@@ -0,0 +1,66 @@
+#ifndef SYMSPELL_H
+#define SYMSPELL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+using namespace std;
+
+class StringPool;
+
+// Chỉ mục xóa đối xứng (kiểu SymSpell): mỗi từ sinh trước mọi biến thể xóa
+// tối đa MAX_DISTANCE ký tự của PREFIX_LENGTH ký tự đầu. Hai từ cách nhau
+// <= k luôn có chung một biến thể, nên tra cứu chỉ cần băm vài chục biến thể
+// của truy vấn rồi kiểm tra lại ứng viên bằng khoảng cách bit-parallel.
+// Bảng chỉ lưu hash 64 bit của biến thể (không lưu chuỗi): va chạm hiếm
+// và đều bị loại ở bước kiểm tra.
+class SymSpellIndex
+{
+    struct Slot
+    {
+        uint64_t hash;
+        uint32_t head; // Posting đầu tiên (EMPTY = slot trống)
+    };
+    struct Posting
+    {
+        uint32_t wordId;
+        uint32_t next;
+    };
+
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    vector<Slot> slots;
+    size_t used = 0;
+    vector<Posting> postings;
+
+    void growSlots();
+    Slot &slotFor(uint64_t hash); // Slot của hash hoặc slot trống để thêm vào
+    const Slot *findSlot(uint64_t hash) const;
+
+public:
+    static constexpr int MAX_DISTANCE = 2;
+    static constexpr size_t PREFIX_LENGTH = 7;
+
+    // Thêm vào out hash của mọi biến thể xóa tối đa maxDeletes ký tự của word
+    static void deleteVariants(string_view word, int maxDeletes, vector<uint64_t> &out);
+
+    void add(uint32_t wordId, string_view word);
+    // Từ đã có được lưu lại với ID mới (vd. đổi chữ hoa/thường)
+    void replace(uint32_t oldId, uint32_t newId, string_view word);
+    // Bỏ từ khỏi chỉ mục (posting được đánh dấu trống, không thu hồi)
+    void remove(uint32_t wordId, string_view word) { replace(wordId, EMPTY, word); }
+
+    // (wordId, khoảng cách) của mọi từ cách input không quá maxDistance
+    // (maxDistance <= MAX_DISTANCE, không phân biệt hoa thường)
+    void lookup(const string &input, int maxDistance, const StringPool &words,
+                vector<pair<uint32_t, int>> &out) const;
+
+    size_t entries() const { return postings.size(); }
+    size_t bytes() const { return slots.capacity() * sizeof(Slot) + postings.capacity() * sizeof(Posting); }
+    void clear();
+};
+
+#endif // SYMSPELL_H
@@ -1,27 +1,489 @@
 #include "trie.h"
 #include <algorithm>
 #include <cctype>
-#include <queue>
-#include <cmath>
-#include <functional>
+#include <cstring>
+#include <new>
 
-Trie::Trie()
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TRIE_USE_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    struct Node4
+    {
+        uint8_t keys[4];
+        TrieNode *child[4];
+    };
+
+    struct Node16
+    {
+        uint8_t keys[16];
+        TrieNode *child[16];
+    };
+
+    struct Node48
+    {
+        uint8_t index[256]; // 0 = không có, ngược lại là slot + 1
+        TrieNode *child[48];
+    };
+
+    struct Node256
+    {
+        TrieNode *child[256];
+    };
+
+    int lowestBit(unsigned x)
+    {
+#if defined(_MSC_VER)
+        unsigned long i;
+        _BitScanForward(&i, x);
+        return (int)i;
+#else
+        return __builtin_ctz(x);
+#endif
+    }
+
+    // Tìm vị trí khóa trong mảng khóa đã sắp xếp (-1 nếu không có)
+    int findKey16(const uint8_t *keys, int count, uint8_t key)
+    {
+#ifdef TRIE_USE_SSE2
+        __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)key),
+                                     _mm_loadu_si128((const __m128i *)keys));
+        unsigned mask = (unsigned)_mm_movemask_epi8(cmp) & ((1u << count) - 1);
+        return mask ? lowestBit(mask) : -1;
+#else
+        for (int i = 0; i < count; i++)
+            if (keys[i] == key)
+                return i;
+        return -1;
+#endif
+    }
+
+    // Chèn (key, child) vào mảng khóa sắp xếp còn chỗ trống
+    void insertSorted(uint8_t *keys, TrieNode **child, int count, uint8_t key, TrieNode *node)
+    {
+        int pos = 0;
+        while (pos < count && keys[pos] < key)
+            pos++;
+        memmove(keys + pos + 1, keys + pos, count - pos);
+        memmove(child + pos + 1, child + pos, (count - pos) * sizeof(TrieNode *));
+        keys[pos] = key;
+        child[pos] = node;
+    }
+}
+
+// ===== ChildMap =====
+
+TrieNode *ChildMap::find(char c) const
+{
+    uint8_t key = (uint8_t)c;
+    switch (type)
+    {
+    case N1:
+        return singleKey == key ? (TrieNode *)data : nullptr;
+    case N4:
+    {
+        const Node4 *n = (const Node4 *)data;
+        for (int i = 0; i < count; i++)
+            if (n->keys[i] == key)
+                return n->child[i];
+        return nullptr;
+    }
+    case N16:
+    {
+        const Node16 *n = (const Node16 *)data;
+        int i = findKey16(n->keys, count, key);
+        return i >= 0 ? n->child[i] : nullptr;
+    }
+    case N48:
+    {
+        const Node48 *n = (const Node48 *)data;
+        return n->index[key] ? n->child[n->index[key] - 1] : nullptr;
+    }
+    case N256:
+        return ((const Node256 *)data)->child[key];
+    default:
+        return nullptr;
+    }
+}
+
+void ChildMap::grow(TrieArena &arena)
 {
-    root = new TrieNode();
+    switch (type)
+    {
+    case N1:
+    {
+        Node4 *n = new (arena.allocate(sizeof(Node4))) Node4();
+        n->keys[0] = singleKey;
+        n->child[0] = (TrieNode *)data;
+        data = n;
+        type = N4;
+        break;
+    }
+    case N4:
+    {
+        Node4 *old = (Node4 *)data;
+        Node16 *n = new (arena.allocate(sizeof(Node16))) Node16();
+        memcpy(n->keys, old->keys, 4);
+        memcpy(n->child, old->child, 4 * sizeof(TrieNode *));
+        arena.release(old, sizeof(Node4));
+        data = n;
+        type = N16;
+        break;
+    }
+    case N16:
+    {
+        Node16 *old = (Node16 *)data;
+        Node48 *n = new (arena.allocate(sizeof(Node48))) Node48();
+        memset(n->index, 0, sizeof(n->index));
+        for (int i = 0; i < count; i++)
+        {
+            n->index[old->keys[i]] = i + 1;
+            n->child[i] = old->child[i];
+        }
+        arena.release(old, sizeof(Node16));
+        data = n;
+        type = N48;
+        break;
+    }
+    case N48:
+    {
+        Node48 *old = (Node48 *)data;
+        Node256 *n = new (arena.allocate(sizeof(Node256))) Node256();
+        memset(n->child, 0, sizeof(n->child));
+        for (int k = 0; k < 256; k++)
+            if (old->index[k])
+                n->child[k] = old->child[old->index[k] - 1];
+        arena.release(old, sizeof(Node48));
+        data = n;
+        type = N256;
+        break;
+    }
+    default:
+        break;
+    }
 }
 
-Trie::~Trie()
+void ChildMap::insert(char c, TrieNode *child, TrieArena &arena)
 {
-    deleteTrie(root);
+    uint8_t key = (uint8_t)c;
+    if (type == Empty)
+    {
+        data = child;
+        singleKey = key;
+        type = N1;
+        count = 1;
+        return;
+    }
+    if (type == N1 || (type == N4 && count == 4) || (type == N16 && count == 16) ||
+        (type == N48 && count == 48))
+        grow(arena);
+
+    switch (type)
+    {
+    case N4:
+        insertSorted(((Node4 *)data)->keys, ((Node4 *)data)->child, count, key, child);
+        break;
+    case N16:
+        insertSorted(((Node16 *)data)->keys, ((Node16 *)data)->child, count, key, child);
+        break;
+    case N48:
+    {
+        Node48 *n = (Node48 *)data;
+        n->child[count] = child;
+        n->index[key] = count + 1;
+        break;
+    }
+    case N256:
+        ((Node256 *)data)->child[key] = child;
+        break;
+    default:
+        break;
+    }
+    count++;
 }
 
-void Trie::deleteTrie(TrieNode *node)
+void ChildMap::erase(char c, TrieArena &arena)
 {
-    if (!node)
+    uint8_t key = (uint8_t)c;
+    switch (type)
+    {
+    case N1:
+        data = nullptr;
+        type = Empty;
+        count = 0;
+        return;
+    case N4:
+    case N16:
+    {
+        uint8_t *keys = type == N4 ? ((Node4 *)data)->keys : ((Node16 *)data)->keys;
+        TrieNode **child = type == N4 ? ((Node4 *)data)->child : ((Node16 *)data)->child;
+        int pos = 0;
+        while (keys[pos] != key)
+            pos++;
+        memmove(keys + pos, keys + pos + 1, count - pos - 1);
+        memmove(child + pos, child + pos + 1, (count - pos - 1) * sizeof(TrieNode *));
+        count--;
+        break;
+    }
+    case N48:
+    {
+        // Dời slot cuối vào chỗ trống để các slot luôn liền nhau
+        Node48 *n = (Node48 *)data;
+        int slot = n->index[key] - 1;
+        int last = count - 1;
+        if (slot != last)
+        {
+            for (int k = 0; k < 256; k++)
+            {
+                if (n->index[k] == last + 1)
+                {
+                    n->index[k] = slot + 1;
+                    break;
+                }
+            }
+            n->child[slot] = n->child[last];
+        }
+        n->index[key] = 0;
+        count--;
+        break;
+    }
+    case N256:
+        ((Node256 *)data)->child[key] = nullptr;
+        count--;
+        break;
+    default:
         return;
-    for (auto &[c, child] : node->children)
-        deleteTrie(child);
-    delete node;
+    }
+
+    // Co lại khi còn ít con hơn nhiều so với sức chứa (có khoảng trễ để tránh dao động)
+    if ((type == N4 && count <= 1) || (type == N16 && count <= 3) ||
+        (type == N48 && count <= 12) || (type == N256 && count <= 37))
+        shrink(arena);
+}
+
+void ChildMap::replace(char c, TrieNode *child)
+{
+    uint8_t key = (uint8_t)c;
+    switch (type)
+    {
+    case N1:
+        data = child;
+        break;
+    case N4:
+    case N16:
+    {
+        uint8_t *keys = type == N4 ? ((Node4 *)data)->keys : ((Node16 *)data)->keys;
+        TrieNode **children = type == N4 ? ((Node4 *)data)->child : ((Node16 *)data)->child;
+        int pos = 0;
+        while (keys[pos] != key)
+            pos++;
+        children[pos] = child;
+        break;
+    }
+    case N48:
+    {
+        Node48 *n = (Node48 *)data;
+        n->child[n->index[key] - 1] = child;
+        break;
+    }
+    case N256:
+        ((Node256 *)data)->child[key] = child;
+        break;
+    default:
+        break;
+    }
+}
+
+void ChildMap::shrink(TrieArena &arena)
+{
+    pair<char, TrieNode *> entries[48];
+    int n = 0;
+    for (auto entry : *this)
+        entries[n++] = entry;
+
+    static const size_t blockSize[] = {0, 0, sizeof(Node4), sizeof(Node16), sizeof(Node48), sizeof(Node256)};
+    arena.release(data, blockSize[type]);
+    data = nullptr;
+    type = Empty;
+    count = 0;
+
+    for (int i = 0; i < n; i++)
+        insert(entries[i].first, entries[i].second, arena);
+}
+
+int ChildMap::endPos() const
+{
+    return (type == N48 || type == N256) ? 256 : count;
+}
+
+void ChildMap::iterator::skipEmpty()
+{
+    if (map->type == N48)
+    {
+        const Node48 *n = (const Node48 *)map->data;
+        while (pos < 256 && !n->index[pos])
+            pos++;
+    }
+    else if (map->type == N256)
+    {
+        const Node256 *n = (const Node256 *)map->data;
+        while (pos < 256 && !n->child[pos])
+            pos++;
+    }
+}
+
+pair<char, TrieNode *> ChildMap::iterator::operator*() const
+{
+    switch (map->type)
+    {
+    case N1:
+        return {(char)map->singleKey, (TrieNode *)map->data};
+    case N4:
+    {
+        const Node4 *n = (const Node4 *)map->data;
+        return {(char)n->keys[pos], n->child[pos]};
+    }
+    case N16:
+    {
+        const Node16 *n = (const Node16 *)map->data;
+        return {(char)n->keys[pos], n->child[pos]};
+    }
+    case N48:
+    {
+        const Node48 *n = (const Node48 *)map->data;
+        return {(char)pos, n->child[n->index[pos] - 1]};
+    }
+    default:
+        return {(char)pos, ((const Node256 *)map->data)->child[pos]};
+    }
+}
+
+// ===== Trie =====
+
+Trie::Trie()
+{
+    root = newNode();
+}
+
+Trie::Trie(Trie &&other) : Trie()
+{
+    swap(other);
+}
+
+Trie &Trie::operator=(Trie &&other)
+{
+    // other nhận nội dung cũ và thả nó khi bị hủy
+    swap(other);
+    return *this;
+}
+
+void Trie::swap(Trie &other)
+{
+    arena.swap(other.arena);
+    std::swap(root, other.root);
+    std::swap(words, other.words);
+    std::swap(usage, other.usage);
+    std::swap(usageClock, other.usageClock);
+    std::swap(liveWords, other.liveWords);
+    std::swap(engine, other.engine);
+    std::swap(symspell, other.symspell);
+    std::swap(trigrams, other.trigrams);
+    std::swap(acronyms, other.acronyms);
+}
+
+void Trie::clear()
+{
+    arena.clear();
+    words.clear();
+    usage.clear();
+    usageClock = 0;
+    liveWords = 0;
+    symspell.reset();
+    trigrams.reset();
+    acronyms.clear();
+    root = newNode();
+}
+
+TrieNode *Trie::newNode()
+{
+    return new (arena.allocate(sizeof(TrieNode))) TrieNode();
+}
+
+size_t Trie::labelCapacity(size_t length)
+{
+    size_t capacity = 8;
+    while (capacity < length)
+        capacity *= 2;
+    return capacity;
+}
+
+void Trie::setLabel(TrieNode *node, const char *chars, size_t length)
+{
+    // chars có thể nằm trong nhãn cũ: chép trước khi trả nhãn cũ
+    char *label = length ? static_cast<char *>(arena.allocate(labelCapacity(length))) : nullptr;
+    if (length)
+        memcpy(label, chars, length);
+    if (node->label)
+        arena.release(node->label, labelCapacity(node->labelLength));
+    node->label = label;
+    node->labelLength = (uint8_t)length;
+}
+
+TrieNode *Trie::splitEdge(TrieNode *parent, char key, TrieNode *child, int offset)
+{
+    TrieNode *middle = newNode();
+    setLabel(middle, child->label, offset);
+    char nextKey = child->label[offset];
+    setLabel(child, child->label + offset + 1, child->labelLength - offset - 1);
+
+    middle->children.insert(nextKey, child, arena);
+    parent->children.replace(key, middle);
+    recomputeStats(middle);
+    return middle;
+}
+
+bool Trie::mergeWithChild(TrieNode *parent, char key, TrieNode *node)
+{
+    auto [childKey, child] = *node->children.begin();
+    size_t length = node->labelLength + 1 + child->labelLength;
+    if (length > TrieNode::MAX_LABEL)
+        return false;
+
+    char merged[TrieNode::MAX_LABEL];
+    // Nhãn rỗng là nullptr: copy_n không đọc gì khi độ dài bằng 0
+    copy_n(node->label, node->labelLength, merged);
+    merged[node->labelLength] = childKey;
+    copy_n(child->label, child->labelLength, merged + node->labelLength + 1);
+    setLabel(child, merged, length);
+
+    // Thống kê và cache top-k của child tính từ vị trí của nó, không đổi
+    parent->children.replace(key, child);
+    node->children.erase(childKey, arena);
+    releaseNode(node);
+    return true;
+}
+
+TrieCursor Trie::walk(const string &text, vector<TrieNode *> *path) const
+{
+    TrieCursor at{root, 0};
+    if (path)
+        path->assign(1, root);
+    for (char c : text)
+    {
+        at = at.next(tolower(c));
+        if (!at.valid())
+            return at;
+        if (path && at.pending == at.node->labelLength)
+            path->push_back(at.node);
+    }
+    return at;
 }
 
 void Trie::insert(const string &word)
@@ -29,138 +491,591 @@ void Trie::insert(const string &word)
     if (word.empty())
         return;
 
+    static thread_local string lower;
+    lower.resize(word.size());
+    for (size_t i = 0; i < word.size(); i++)
+        lower[i] = tolower(word[i]);
+    size_t len = lower.size();
+
+    // path[k] là node thứ k trên đường đi, ở độ sâu depths[k]
+    static thread_local vector<TrieNode *> path;
+    static thread_local vector<size_t> depths;
+    path.assign(1, root);
+    depths.assign(1, 0);
+
     TrieNode *node = root;
-    string normalized;
+    size_t i = 0;
+    while (i < len)
+    {
+        char key = lower[i];
+        TrieNode *next = node->children.find(key);
+        if (!next)
+        {
+            // Phần còn lại của từ thành một cạnh (nhiều cạnh nếu quá MAX_LABEL)
+            next = newNode();
+            size_t length = min<size_t>(len - i - 1, TrieNode::MAX_LABEL);
+            setLabel(next, lower.data() + i + 1, length);
+            node->children.insert(key, next, arena);
+            i += 1 + length;
+        }
+        else
+        {
+            // Khớp nhãn; lệch (hoặc hết từ) giữa nhãn thì tách cạnh tại đó
+            int offset = 0;
+            while (offset < next->labelLength && i + 1 + offset < len && next->label[offset] == lower[i + 1 + offset])
+                offset++;
+            if (offset < next->labelLength)
+                next = splitEdge(node, key, next, offset);
+            i += 1 + offset;
+        }
+        node = next;
+        path.push_back(node);
+        depths.push_back(i);
+    }
 
-    for (char c : word)
+    // Cập nhật thống kê cây con từ dưới lên
+    uint32_t suffixMask = 0;
+    size_t masked = len;
+    for (size_t k = path.size(); k-- > 0;)
     {
-        char lowerC = tolower(c);
-        normalized += lowerC;
+        TrieNode *n = path[k];
+        while (masked > depths[k])
+            suffixMask |= 1u << (lower[--masked] & 31);
+        uint8_t remaining = (uint8_t)min<size_t>(len - depths[k], 255);
+        n->minRemaining = min(n->minRemaining, remaining);
+        n->maxRemaining = max(n->maxRemaining, remaining);
+        n->charMask |= suffixMask;
+    }
+
+    // Lưu từ gốc để hiển thị; chỉ thêm vào kho khi khác với từ đã lưu
+    if (!node->isEnd() || words.view(node->wordId) != word)
+    {
+        int32_t oldId = node->wordId;
+        node->wordId = words.add(word);
+        usage.resize(words.size());
+        if (oldId >= 0)
+            usage[node->wordId] = usage[oldId];
+        else
+            liveWords++;
+
+        // Cache top-k từ dưới lên: cache của con đã đúng khi tới node cha
+        for (size_t k = path.size(); k-- > 0;)
+        {
+            TrieNode *n = path[k];
+            if (!n->isEnd() && n->children.size() < 2)
+                continue;
+            if (!n->topK)
+                buildTopK(n);
+            else if (oldId >= 0)
+                renameTopK(n, oldId, node->wordId);
+            else
+                offerTopK(n, entryFor(node->wordId), false);
+        }
 
-        if (!node->children.count(lowerC))
-            node->children[lowerC] = new TrieNode();
-        node = node->children[lowerC];
+        // Đổi hoa/thường có thể đổi ranh giới camelCase
+        if (oldId >= 0)
+            acronyms.remove(oldId, words.view(oldId));
+        acronyms.add(node->wordId, word);
+        if (symspell)
+        {
+            if (oldId >= 0)
+                symspell->replace(oldId, node->wordId, word);
+            else
+                symspell->add(node->wordId, word);
+        }
+        if (trigrams)
+        {
+            if (oldId >= 0)
+                trigrams->remove(oldId);
+            trigrams->add(node->wordId, word);
+        }
     }
-    node->isEnd = true;
-    node->originalWord = word; // Lưu từ gốc để hiển thị
 }
 
-bool Trie::search(const string &word)
+vector<uint32_t> Trie::currentWordIds() const
 {
-    TrieNode *node = root;
-    for (char c : word)
+    // Chỉ lấy ID đang gắn với node: kho chuỗi còn giữ bản cũ của từ đổi hoa/thường
+    vector<uint32_t> ids;
+    vector<TrieNode *> stack{root};
+    while (!stack.empty())
+    {
+        TrieNode *node = stack.back();
+        stack.pop_back();
+        if (node->isEnd())
+            ids.push_back(node->wordId);
+        for (auto [c, child] : node->children)
+            stack.push_back(child);
+    }
+    sort(ids.begin(), ids.end());
+    return ids;
+}
+
+void Trie::buildSymSpellIndex()
+{
+    symspell = make_unique<SymSpellIndex>();
+    for (uint32_t id : currentWordIds())
+        symspell->add(id, words.view(id));
+}
+
+void Trie::buildTrigramIndex()
+{
+    // Danh sách posting cần ID tăng dần
+    trigrams = make_unique<TrigramIndex>();
+    for (uint32_t id : currentWordIds())
+        trigrams->add(id, words.view(id));
+}
+
+void Trie::releaseNode(TrieNode *node)
+{
+    releaseTopK(node);
+    setLabel(node, nullptr, 0);
+    node->~TrieNode();
+    arena.release(node, sizeof(TrieNode));
+}
+
+void Trie::recomputeStats(TrieNode *node)
+{
+    uint8_t minRemaining = node->isEnd() ? 0 : 255;
+    uint8_t maxRemaining = 0;
+    uint32_t charMask = 0;
+    for (auto [c, child] : node->children)
+    {
+        TrieCursor edge = TrieCursor::at(child);
+        minRemaining = min<int>(minRemaining, min(edge.minRemaining() + 1, 255));
+        maxRemaining = max<int>(maxRemaining, min(edge.maxRemaining() + 1, 255));
+        charMask |= (1u << (c & 31)) | edge.charMask();
+    }
+    node->minRemaining = minRemaining;
+    node->maxRemaining = maxRemaining;
+    node->charMask = charMask;
+}
+
+bool Trie::remove(const string &word)
+{
+    static thread_local vector<TrieNode *> path;
+    TrieCursor at = walk(word, &path);
+    if (!at.valid() || !at.isEnd())
+        return false;
+    TrieNode *node = at.node;
+
+    uint32_t oldId = node->wordId;
+    string_view stored = words.view(oldId);
+    if (symspell)
+        symspell->remove(oldId, stored);
+    if (trigrams)
+        trigrams->remove(oldId);
+    acronyms.remove(oldId, stored);
+
+    node->wordId = -1;
+    usage[oldId] = WordUsage();
+    liveWords--;
+
+    // Ký tự khóa của path[k] trong node cha nằm ở độ sâu của node cha
+    static thread_local vector<size_t> depths;
+    depths.assign(1, 0);
+    for (size_t k = 1; k < path.size(); k++)
+        depths.push_back(depths[k - 1] + 1 + path[k]->labelLength);
+
+    // Từ dưới lên: bỏ node không còn con và không kết thúc từ, gộp node chỉ
+    // còn một con vào cạnh của con đó, cập nhật thống kê và cache top-k của
+    // phần còn lại
+    for (size_t k = path.size(); k-- > 0;)
     {
-        char lowerC = tolower(c);
-        if (!node->children.count(lowerC))
-            return false;
-        node = node->children[lowerC];
+        TrieNode *n = path[k];
+        if (k > 0 && !n->isEnd() && n->children.size() < 2)
+        {
+            char key = tolower(word[depths[k - 1]]);
+            if (n->children.empty())
+            {
+                path[k - 1]->children.erase(key, arena);
+                releaseNode(n);
+                continue;
+            }
+            if (mergeWithChild(path[k - 1], key, n))
+                continue;
+        }
+
+        recomputeStats(n);
+
+        if (!n->isEnd() && n->children.size() < 2)
+        {
+            releaseTopK(n);
+            continue;
+        }
+
+        const TopKCache *cache = n->topK;
+        bool stale = !cache;
+        for (int i = 0; cache && i < cache->count && !stale; i++)
+            stale = cache->entries()[i].wordId == oldId;
+        if (stale)
+        {
+            releaseTopK(n);
+            buildTopK(n);
+        }
+    }
+
+    // Kho chuỗi chỉ thêm vào: dọn khi phần chết chiếm đa số (chi phí chia đều)
+    if (words.size() > 2 * liveWords + 1024)
+        compactStrings();
+    return true;
+}
+
+void Trie::compactStrings()
+{
+    StringPool live;
+    vector<WordUsage> liveUsage;
+    vector<int32_t> remap(words.size(), -1);
+
+    vector<TrieNode *> stack{root}, nodes;
+    while (!stack.empty())
+    {
+        TrieNode *node = stack.back();
+        stack.pop_back();
+        nodes.push_back(node);
+        if (node->isEnd())
+        {
+            remap[node->wordId] = live.add(words.view(node->wordId));
+            liveUsage.push_back(usage[node->wordId]);
+            node->wordId = remap[node->wordId];
+        }
+        for (auto [c, child] : node->children)
+            stack.push_back(child);
     }
-    return node->isEnd;
+
+    for (TrieNode *node : nodes)
+    {
+        if (!node->topK)
+            continue;
+        for (int k = 0; k < node->topK->count; k++)
+            node->topK->entries()[k].wordId = remap[node->topK->entries()[k].wordId];
+    }
+
+    words = move(live);
+    usage = move(liveUsage);
+
+    // Các chỉ mục phụ giữ wordId cũ: dựng lại (SymSpell/trigram dựng lười khi cần)
+    symspell.reset();
+    trigrams.reset();
+    acronyms.clear();
+    for (uint32_t id = 0; id < words.size(); id++)
+        acronyms.add(id, words.view(id));
+}
+
+bool Trie::search(const string &word)
+{
+    TrieCursor at = walk(word);
+    return at.valid() && at.isEnd();
 }
 
-void Trie::dfs(TrieNode *node, string prefix, vector<string> &result)
+void Trie::dfs(TrieNode *node, string &prefix, vector<string> &result)
 {
-    if (node->isEnd)
-        result.push_back(node->originalWord.empty() ? prefix : node->originalWord);
+    if (node->isEnd())
+        result.push_back(words.get(node->wordId));
 
-    for (auto &[c, child] : node->children)
-        dfs(child, prefix + c, result);
+    for (auto [c, child] : node->children)
+    {
+        prefix.push_back(c);
+        prefix.append(child->label, child->labelLength);
+        dfs(child, prefix, result);
+        prefix.resize(prefix.size() - 1 - child->labelLength);
+    }
 }
 
 vector<string> Trie::getAllWords()
 {
     vector<string> result;
-    dfs(root, "", result);
+    string prefix;
+    dfs(root, prefix, result);
     return result;
 }
 
-void Trie::collectWordsWithPrefix(TrieNode *node, string prefix, vector<string> &result, int limit)
+void Trie::forEachWord(const function<void(string_view, uint32_t)> &visit) const
 {
-    if (result.size() >= limit)
-        return;
+    for (uint32_t id : currentWordIds())
+        visit(words.view(id), usage[id].weight);
+}
 
-    if (node->isEnd)
+// ===== Cache top-k =====
+
+TopKEntry Trie::entryFor(uint32_t wordId) const
+{
+    return {wordId, usage[wordId].weight, usage[wordId].lastUsed};
+}
+
+bool Trie::rankedBefore(const TopKEntry &a, const TopKEntry &b) const
+{
+    if (a.weight != b.weight)
+        return a.weight > b.weight;
+    if (a.lastUsed != b.lastUsed)
+        return a.lastUsed > b.lastUsed;
+
+    string_view x = words.view(a.wordId), y = words.view(b.wordId);
+    for (size_t i = 0; i < x.size() && i < y.size(); i++)
     {
-        result.push_back(node->originalWord.empty() ? prefix : node->originalWord);
+        char cx = tolower(x[i]), cy = tolower(y[i]);
+        if (cx != cy)
+            return cx < cy;
     }
+    return x.size() < y.size();
+}
 
-    if (result.size() >= limit)
+void Trie::releaseTopK(TrieNode *node)
+{
+    if (!node->topK)
         return;
+    arena.release(node->topK, sizeof(TopKCache) + node->topK->capacity * sizeof(TopKEntry));
+    node->topK = nullptr;
+}
 
-    for (auto &[c, child] : node->children)
+TopKCache *Trie::allocateTopK(uint16_t capacity)
+{
+    TopKCache *cache = static_cast<TopKCache *>(arena.allocate(sizeof(TopKCache) + capacity * sizeof(TopKEntry)));
+    cache->count = 0;
+    cache->capacity = capacity;
+    return cache;
+}
+
+const TopKCache *Trie::effectiveTopK(const TrieNode *node) const
+{
+    // Node không có cache nằm trên chuỗi một con, không kết thúc từ
+    while (!node->topK)
+        node = (*node->children.begin()).second;
+    return node->topK;
+}
+
+void Trie::buildTopK(TrieNode *node)
+{
+    static thread_local vector<TopKEntry> merged;
+    merged.clear();
+    if (node->isEnd())
+        merged.push_back(entryFor(node->wordId));
+    for (auto [c, child] : node->children)
     {
-        collectWordsWithPrefix(child, prefix + c, result, limit);
-        if (result.size() >= limit)
-            return;
+        const TopKCache *cache = effectiveTopK(child);
+        merged.insert(merged.end(), cache->entries(), cache->entries() + cache->count);
     }
+
+    size_t keep = min<size_t>(TopKCache::K, merged.size());
+    partial_sort(merged.begin(), merged.begin() + keep, merged.end(),
+                 [this](const TopKEntry &a, const TopKEntry &b) { return rankedBefore(a, b); });
+
+    uint16_t capacity = 1;
+    while (capacity < keep)
+        capacity = min<uint16_t>(capacity * 2, TopKCache::K);
+    node->topK = allocateTopK(capacity);
+    node->topK->count = keep;
+    copy(merged.begin(), merged.begin() + keep, node->topK->entries());
 }
 
-vector<string> Trie::findWordsWithPrefix(const string &prefix, int limit)
+void Trie::offerTopK(TrieNode *node, const TopKEntry &entry, bool present)
 {
-    vector<string> result;
-    if (prefix.empty())
-        return result;
+    TopKCache *cache = node->topK;
+    TopKEntry *e = cache->entries();
 
-    TrieNode *node = root;
-    string normalizedPrefix;
+    // Trọng số chỉ tăng: từ đã có trong cache chỉ có thể tiến lên
+    int pos = -1;
+    for (int i = 0; i < cache->count && present; i++)
+    {
+        if (e[i].wordId == entry.wordId)
+        {
+            pos = i;
+            break;
+        }
+    }
 
-    for (char c : prefix)
+    if (pos < 0)
     {
-        char lowerC = tolower(c);
-        normalizedPrefix += lowerC;
+        if (cache->count == TopKCache::K)
+        {
+            if (!rankedBefore(entry, e[cache->count - 1]))
+                return;
+            pos = cache->count - 1;
+        }
+        else
+        {
+            if (cache->count == cache->capacity)
+            {
+                TopKCache *grown = allocateTopK(min<uint16_t>(cache->capacity * 2, TopKCache::K));
+                grown->count = cache->count;
+                copy(e, e + cache->count, grown->entries());
+                arena.release(cache, sizeof(TopKCache) + cache->capacity * sizeof(TopKEntry));
+                node->topK = cache = grown;
+                e = cache->entries();
+            }
+            pos = cache->count++;
+        }
+    }
 
-        if (!node->children.count(lowerC))
-            return result; // Không tìm thấy prefix
+    e[pos] = entry;
+    for (; pos > 0 && rankedBefore(e[pos], e[pos - 1]); pos--)
+        std::swap(e[pos], e[pos - 1]);
+}
 
-        node = node->children[lowerC];
+void Trie::renameTopK(TrieNode *node, uint32_t oldId, uint32_t newId)
+{
+    // Thứ tự không đổi: so sánh chữ cái không phân biệt hoa thường
+    TopKCache *cache = node->topK;
+    for (int i = 0; i < cache->count; i++)
+    {
+        if (cache->entries()[i].wordId == oldId)
+            cache->entries()[i].wordId = newId;
     }
+}
 
-    // Thu thập tất cả từ từ node này
-    collectWordsWithPrefix(node, normalizedPrefix, result, limit);
-
-    return result;
+void Trie::collectEntries(TrieNode *node, vector<TopKEntry> &result) const
+{
+    if (node->isEnd())
+        result.push_back(entryFor(node->wordId));
+    for (auto [c, child] : node->children)
+        collectEntries(child, result);
 }
 
-// Helper function để wrap findWordsWithPrefix cho A* search
-static vector<string> findWordsWithPrefixWrapper(TrieNode* root, const string& prefix, int limit)
+vector<string> Trie::findWordsWithPrefix(const string &prefix, int limit) const
 {
-    // Tạo Trie tạm để gọi findWordsWithPrefix
-    // Note: Đây là wrapper function, thực tế A* sẽ gọi trực tiếp
     vector<string> result;
-    if (prefix.empty())
+    if (prefix.empty() || limit <= 0)
         return result;
 
-    TrieNode *node = root;
-    string normalizedPrefix;
+    // Dừng giữa một cạnh: cây con của node cuối cạnh có đúng các từ đó
+    TrieCursor at = walk(prefix);
+    if (!at.valid())
+        return result; // Không tìm thấy prefix
+    TrieNode *node = at.node;
 
-    for (char c : prefix)
+    // Cache chưa đầy nghĩa là đã chứa mọi từ của cây con
+    const TopKCache *cache = effectiveTopK(node);
+    if (limit <= cache->count || cache->count < TopKCache::K)
     {
-        char lowerC = tolower(c);
-        normalizedPrefix += lowerC;
+        for (int i = 0; i < min(limit, (int)cache->count); i++)
+            result.push_back(words.get(cache->entries()[i].wordId));
+        return result;
+    }
 
-        if (!node->children.count(lowerC))
-            return result;
+    // Cần nhiều hơn K từ: duyệt cả cây con rồi xếp hạng
+    vector<TopKEntry> entries;
+    collectEntries(node, entries);
+    size_t keep = min<size_t>(limit, entries.size());
+    partial_sort(entries.begin(), entries.begin() + keep, entries.end(),
+                 [this](const TopKEntry &a, const TopKEntry &b) { return rankedBefore(a, b); });
+    for (size_t i = 0; i < keep; i++)
+        result.push_back(words.get(entries[i].wordId));
+    return result;
+}
+
+bool Trie::addWeight(const string &word, uint32_t amount)
+{
+    static thread_local vector<TrieNode *> path;
+    TrieCursor at = walk(word, &path);
+    if (!at.valid() || !at.isEnd())
+        return false;
+    TrieNode *node = at.node;
 
-        node = node->children[lowerC];
+    WordUsage &u = usage[node->wordId];
+    u.weight += amount;
+    u.lastUsed = ++usageClock;
+
+    TopKEntry entry = entryFor(node->wordId);
+    for (size_t i = path.size(); i-- > 0;)
+    {
+        if (path[i]->topK)
+            offerTopK(path[i], entry, true);
     }
+    return true;
+}
 
-    // Thu thập từ đây (simplified version)
-    function<void(TrieNode*, string)> collect = [&](TrieNode* n, string p) {
-        if (result.size() >= (size_t)limit) return;
-        if (n->isEnd) {
-            result.push_back(n->originalWord.empty() ? p : n->originalWord);
-        }
-        for (auto &[c, child] : n->children) {
-            collect(child, p + c);
-            if (result.size() >= (size_t)limit) return;
+uint32_t Trie::weight(const string &word) const
+{
+    TrieCursor at = walk(word);
+    return at.valid() && at.isEnd() ? usage[at.node->wordId].weight : 0;
+}
+
+vector<string> Trie::findWordsContaining(const string &text, int limit)
+{
+    if (!trigrams && text.size() >= 3)
+        buildTrigramIndex();
+    return static_cast<const Trie &>(*this).findWordsContaining(text, limit);
+}
+
+vector<string> Trie::findWordsContaining(const string &text, int limit) const
+{
+    if (text.size() < 3 || limit <= 0 || !trigrams)
+        return {};
+
+    // Ứng viên: chứa đúng text, thêm các từ chứa text với lỗi gõ khi còn thiếu
+    vector<uint32_t> ids;
+    trigrams->findContaining(text, words, limit * 4, ids);
+
+    if ((int)ids.size() < limit)
+    {
+        vector<pair<uint32_t, int>> approximate;
+        int maxErrors = text.size() >= 10 ? 2 : 1;
+        while (maxErrors > 0 && !trigrams->findApproximate(text, maxErrors, words, limit * 4, approximate))
+            maxErrors--;
+        for (auto [id, errors] : approximate)
+        {
+            if (find(ids.begin(), ids.end(), id) == ids.end())
+                ids.push_back(id);
         }
-    };
-    
-    collect(node, normalizedPrefix);
+    }
+
+    vector<pair<int, string>> ranked;
+    for (uint32_t id : ids)
+    {
+        string candidate = words.get(id);
+        ranked.push_back({calculateRankingScore(text, candidate), candidate});
+    }
+    sort(ranked.begin(), ranked.end());
+
+    vector<string> result;
+    for (int i = 0; i < min(limit, (int)ranked.size()); i++)
+        result.push_back(ranked[i].second);
     return result;
 }
 
-vector<string> Trie::findSimilarWords(const string &word, int maxSuggestions)
+vector<string> Trie::findWordsByAbbreviation(const string &abbrev, int limit) const
 {
-    return findSimilarWordsAStar(root, word, maxSuggestions, findWordsWithPrefixWrapper);
-}
\ No newline at end of file
+    vector<uint32_t> ids;
+    acronyms.find(abbrev, words, limit, ids);
+
+    vector<string> result;
+    for (uint32_t id : ids)
+        result.push_back(words.get(id));
+    return result;
+}
+
+void Trie::prepareIndexes()
+{
+    if (!trigrams)
+        buildTrigramIndex();
+    if (engine == FuzzyEngine::SymSpell && !symspell)
+        buildSymSpellIndex();
+}
+
+vector<string> Trie::findSimilarWords(const string &word, int maxSuggestions,
+                                      const function<bool(const string &)> &accept)
+{
+    if (engine == FuzzyEngine::Levenshtein)
+        return findSimilarWordsLevenshtein(root, words, word, maxSuggestions, accept);
+    if (engine == FuzzyEngine::Automaton)
+        return findSimilarWordsAutomaton(root, words, word, maxSuggestions, accept);
+    if (engine == FuzzyEngine::SymSpell)
+    {
+        if (!symspell)
+            buildSymSpellIndex();
+        return findSimilarWordsSymSpell(root, words, *symspell, word, maxSuggestions, accept);
+    }
+    return findSimilarWordsAStar(root, words, word, maxSuggestions, accept);
+}
+
+vector<vector<string>> Trie::findSimilarWordsBatch(const vector<string> &queries, int maxSuggestions,
+                                                   const function<bool(size_t, const string &)> &accept,
+                                                   int threads) const
+{
+    return ::findSimilarWordsBatch(root, words, queries, maxSuggestions, accept, threads);
+}
+
+size_t Trie::memoryUsage() const
+{
+    return arena.bytes() + words.bytes() + (symspell ? symspell->bytes() : 0) +
+           (trigrams ? trigrams->bytes() : 0) + acronyms.bytes();
+}
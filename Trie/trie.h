@@ -4,39 +4,280 @@
 
 #include <string>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
+#include <cstdint>
+#include <memory>
+#include <algorithm>
 #include "fuzzy_search.h"
+#include "string_pool.h"
+#include "trie_arena.h"
+#include "symspell.h"
+#include "trigram_index.h"
+#include "acronym_index.h"
 
 using namespace std;
 
+struct TrieNode;
+
+// Danh sách con thích nghi theo số lượng (kiểu Adaptive Radix Tree):
+// một con duy nhất lưu ngay trong map (không tốn cấp phát), Node4 / Node16 (khóa sắp xếp, Node16 tìm bằng SIMD), Node48
+// (bảng chỉ số 256 byte), Node256 (mảng con trực tiếp).
+// Duyệt luôn theo thứ tự ký tự. Bộ nhớ lấy từ TrieArena của trie sở hữu.
+class ChildMap
+{
+public:
+    enum Kind : uint8_t
+    {
+        Empty,
+        N1,
+        N4,
+        N16,
+        N48,
+        N256
+    };
+
+    class iterator
+    {
+        const ChildMap *map;
+        int pos;
+        void skipEmpty();
+
+    public:
+        iterator(const ChildMap *m, int p) : map(m), pos(p) { skipEmpty(); }
+        pair<char, TrieNode *> operator*() const;
+        iterator &operator++()
+        {
+            pos++;
+            skipEmpty();
+            return *this;
+        }
+        bool operator!=(const iterator &o) const { return pos != o.pos; }
+    };
+
+    ChildMap() = default;
+    ChildMap(const ChildMap &) = delete;
+    ChildMap &operator=(const ChildMap &) = delete;
+
+    TrieNode *find(char c) const;
+    void insert(char c, TrieNode *child, TrieArena &arena); // c chưa có trong map
+    void erase(char c, TrieArena &arena);                    // c có trong map
+    void replace(char c, TrieNode *child);                   // c có trong map
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Kind kind() const { return type; }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, endPos()); }
+
+private:
+    void *data = nullptr; // N1: chính là TrieNode con
+    Kind type = Empty;
+    uint8_t singleKey = 0;
+    uint16_t count = 0;
+
+    int endPos() const;
+    void grow(TrieArena &arena);
+    // Dựng lại ở loại nhỏ nhất đủ chứa các con hiện có
+    void shrink(TrieArena &arena);
+};
+
+// Một từ trong cache top-k: xếp theo trọng số giảm dần, lần dùng gần nhất,
+// rồi thứ tự chữ cái (không phân biệt hoa thường)
+struct TopKEntry
+{
+    uint32_t wordId;
+    uint32_t weight;
+    uint32_t lastUsed;
+};
+
+// Top-k từ của một cây con, cấp phát trong arena; entries nằm ngay sau header
+struct TopKCache
+{
+    static constexpr uint16_t K = 10;
+
+    uint16_t count;
+    uint16_t capacity; // Tăng dần 1, 2, 4, 8, K
+
+    TopKEntry *entries() { return reinterpret_cast<TopKEntry *>(this + 1); }
+    const TopKEntry *entries() const { return reinterpret_cast<const TopKEntry *>(this + 1); }
+};
+
+// Nén đường đi: cạnh từ node cha tới node gồm ký tự khóa trong ChildMap của
+// cha và nhãn (label) phía sau nó. Chuỗi node một con, không kết thúc từ được
+// gộp thành một cạnh; nhãn dài tối đa MAX_LABEL (dài hơn thì nối nhiều node).
 struct TrieNode
 {
-    unordered_map<char, TrieNode *> children;
-    bool isEnd = false;
-    string originalWord; // Lưu từ gốc với chữ hoa/thường gốc
+    static constexpr int MAX_LABEL = 255;
+
+    ChildMap children;
+    char *label = nullptr; // Chữ thường, cấp phát trong arena (xem Trie::labelCapacity)
+    int32_t wordId = -1;   // ID trong StringPool của từ gốc (chữ hoa/thường gốc)
+
+    // Thống kê của cây con cho heuristic A*: số ký tự còn lại ngắn/dài nhất
+    // tới một từ kết thúc (255 = chưa có), và tập ký tự xuất hiện bên dưới
+    // (bit c & 31, va chạm chỉ làm cận dưới yếu đi)
+    uint8_t minRemaining = 255;
+    uint8_t maxRemaining = 0;
+    uint8_t labelLength = 0;
+    uint32_t charMask = 0;
+
+    // Chỉ có ở node rẽ nhánh (>= 2 con) hoặc kết thúc từ; node trên chuỗi
+    // một con dùng chung cache của node có cache đầu tiên bên dưới
+    TopKCache *topK = nullptr;
+
+    bool isEnd() const { return wordId >= 0; }
+};
+
+// Vị trí theo từng ký tự trên trie đã nén: ngay tại node (pending = 0) hoặc
+// giữa cạnh đi vào node, còn pending ký tự của nhãn nữa mới tới node. Các
+// engine fuzzy đi từng ký tự nên duyệt bằng cursor thay vì bằng node.
+struct TrieCursor
+{
+    TrieNode *node = nullptr;
+    uint8_t pending = 0;
+
+    static TrieCursor at(TrieNode *node) { return {node, node->labelLength}; }
+
+    bool valid() const { return node != nullptr; }
+    bool isEnd() const { return pending == 0 && node->isEnd(); }
+    int minRemaining() const { return min(node->minRemaining + pending, 255); }
+    int maxRemaining() const { return min(node->maxRemaining + pending, 255); }
+    uint32_t charMask() const
+    {
+        uint32_t mask = node->charMask;
+        for (int i = node->labelLength - pending; i < node->labelLength; i++)
+            mask |= 1u << (node->label[i] & 31);
+        return mask;
+    }
+
+    // Cursor sau ký tự c (không hợp lệ nếu không có)
+    TrieCursor next(char c) const
+    {
+        if (pending > 0)
+            return node->label[node->labelLength - pending] == c ? TrieCursor{node, uint8_t(pending - 1)} : TrieCursor{};
+        TrieNode *child = node->children.find(c);
+        return child ? at(child) : TrieCursor{};
+    }
+
+    // visit(c, cursor) cho từng ký tự có thể đi tiếp, theo thứ tự ký tự
+    template <typename Visit>
+    void forEachNext(Visit &&visit) const
+    {
+        if (pending > 0)
+        {
+            visit(node->label[node->labelLength - pending], TrieCursor{node, uint8_t(pending - 1)});
+            return;
+        }
+        for (auto [c, child] : node->children)
+            visit(c, at(child));
+    }
+
+    bool operator==(const TrieCursor &o) const { return node == o.node && pending == o.pending; }
 };
 
 class Trie
 {
 private:
+    TrieArena arena;
     TrieNode *root;
+    StringPool words;
+    // Trọng số sử dụng theo wordId (số lần xuất hiện, gợi ý được chọn)
+    struct WordUsage
+    {
+        uint32_t weight = 0;
+        uint32_t lastUsed = 0;
+    };
+    vector<WordUsage> usage;
+    uint32_t usageClock = 0;
+    size_t liveWords = 0; // Số từ hiện có (kho chuỗi còn giữ bản cũ/đã xóa)
+    FuzzyEngine engine = FuzzyEngine::AStar;
+    // Chỉ mục cho engine SymSpell: dựng lần đầu dùng, sau đó cập nhật theo insert
+    unique_ptr<SymSpellIndex> symspell;
+    // Chỉ mục trigram cho tìm đoạn con, cũng dựng lười như trên
+    unique_ptr<TrigramIndex> trigrams;
+    // Chữ cái đầu các đoạn camelCase/snake_case, cập nhật ngay khi insert
+    AcronymIndex acronyms;
+
+    TrieNode *newNode();
+    void releaseNode(TrieNode *node);
+    // Nhãn cấp phát theo lũy thừa của 2 để số lớp kích thước của arena có hạn
+    static size_t labelCapacity(size_t length);
+    void setLabel(TrieNode *node, const char *chars, size_t length);
+    // Tách cạnh vào child sau offset ký tự của nhãn; trả về node mới ở điểm tách
+    TrieNode *splitEdge(TrieNode *parent, char key, TrieNode *child, int offset);
+    // Gộp node một con, không kết thúc từ vào con của nó (nếu nhãn gộp còn vừa)
+    bool mergeWithChild(TrieNode *parent, char key, TrieNode *node);
+    // Đi theo text; path (nếu có) nhận các node đi qua, bắt đầu từ gốc
+    TrieCursor walk(const string &text, vector<TrieNode *> *path = nullptr) const;
+    // Thống kê cây con (min/maxRemaining, charMask) tính lại từ các con
+    void recomputeStats(TrieNode *node);
+    // Dựng lại kho chuỗi chỉ với các từ còn sống, đánh số lại wordId
+    void compactStrings();
+    // ID của mọi từ hiện có (tăng dần)
+    vector<uint32_t> currentWordIds() const;
+    void buildSymSpellIndex();
+    void buildTrigramIndex();
+    void dfs(TrieNode *node, string &prefix, vector<string> &result);
+    void collectEntries(TrieNode *node, vector<TopKEntry> &result) const;
 
-    void dfs(TrieNode *node, string prefix, vector<string> &result);
-    void collectWordsWithPrefix(TrieNode *node, string prefix, vector<string> &result, int limit);
-    void deleteTrie(TrieNode *node);
+    TopKEntry entryFor(uint32_t wordId) const;
+    bool rankedBefore(const TopKEntry &a, const TopKEntry &b) const;
+    TopKCache *allocateTopK(uint16_t capacity);
+    const TopKCache *effectiveTopK(const TrieNode *node) const;
+    void buildTopK(TrieNode *node);
+    void releaseTopK(TrieNode *node);
+    // present: từ có thể đã nằm trong cache (tăng trọng số), ngược lại là từ mới
+    void offerTopK(TrieNode *node, const TopKEntry &entry, bool present);
+    void renameTopK(TrieNode *node, uint32_t oldId, uint32_t newId);
 
 public:
     Trie();
-    ~Trie();
+    ~Trie() = default; // Node nằm trong arena: thả slab là xong
+    Trie(Trie &&other);
+    Trie &operator=(Trie &&other);
+    Trie(const Trie &) = delete;
+    Trie &operator=(const Trie &) = delete;
+
+    void swap(Trie &other);
+    // Xóa toàn bộ từ, giữ trie dùng tiếp được
+    void clear();
 
     void insert(const string &word);
+    // Xóa từ, thu hồi các node không còn dẫn tới từ nào
+    bool remove(const string &word);
     bool search(const string &word);
     vector<string> getAllWords();
-    vector<string> findWordsWithPrefix(const string &prefix, int limit = 10);
+    // Mọi từ kèm trọng số sử dụng (thứ tự không xác định)
+    void forEachWord(const function<void(string_view, uint32_t)> &visit) const;
+    // Từ có tiền tố prefix, xếp theo trọng số sử dụng; O(|prefix| + k) khi limit <= TopKCache::K
+    vector<string> findWordsWithPrefix(const string &prefix, int limit = 10) const;
+    // Tăng trọng số sử dụng của từ đã có (đồng thời đánh dấu dùng gần nhất)
+    bool addWeight(const string &word, uint32_t amount = 1);
+    uint32_t weight(const string &word) const;
+    // Từ chứa text ở bất kỳ vị trí nào (vd. "count" -> getCount, row_count), cho
+    // phép lỗi gõ với text đủ dài; xếp hạng bằng calculateRankingScore
+    vector<string> findWordsContaining(const string &text, int limit = 10);
+    // Bản chỉ đọc: dùng chỉ mục trigram đã dựng (rỗng nếu chưa gọi prepareIndexes)
+    vector<string> findWordsContaining(const string &text, int limit = 10) const;
+    // Từ khớp viết tắt theo ranh giới từ (vd. "gcc" -> getCharCount, "rbs" -> read_buffer_size)
+    vector<string> findWordsByAbbreviation(const string &abbrev, int limit = 10) const;
+    // Dựng trước các chỉ mục lười (trigram, SymSpell nếu engine dùng tới) để các
+    // truy vấn sau đó không ghi vào trie - cần khi nhiều luồng cùng đọc
+    void prepareIndexes();
+
+    // Fuzzy matching bằng engine đang chọn; accept (nếu có) lọc các từ được phép gợi ý
+    vector<string> findSimilarWords(const string &word, int maxSuggestions = 5,
+                                    const function<bool(const string &)> &accept = nullptr);
+    // Nhiều truy vấn chung một lần duyệt (xem findSimilarWordsBatch), không phụ thuộc engine
+    vector<vector<string>> findSimilarWordsBatch(const vector<string> &queries, int maxSuggestions = 5,
+                                                 const function<bool(size_t, const string &)> &accept = nullptr,
+                                                 int threads = 1) const;
+    void setFuzzyEngine(FuzzyEngine e) { engine = e; }
+    FuzzyEngine fuzzyEngine() const { return engine; }
 
-    // A* Search cho fuzzy matching
-    vector<string> findSimilarWords(const string &word, int maxSuggestions = 5);
+    size_t size() const { return liveWords; }
+    // Ước lượng bộ nhớ của node, danh sách con, kho chuỗi và chỉ mục phụ
+    size_t memoryUsage() const;
 };
 
-#endif // TRIE_H
\ No newline at end of file
+#endif // TRIE_H
@@ -0,0 +1,79 @@
+#include "trie_arena.h"
+#include <utility>
+
+int TrieArena::sizeClass(size_t bytes)
+{
+    for (int i = 0; i < SIZE_CLASSES; i++)
+    {
+        if (classSize[i] == bytes)
+            return i;
+        if (classSize[i] == 0)
+        {
+            classSize[i] = bytes;
+            return i;
+        }
+    }
+    return -1; // Hết lớp: khối trả lại bị bỏ đến khi clear()
+}
+
+void *TrieArena::allocate(size_t bytes)
+{
+    bytes = roundUp(bytes);
+
+    int cls = sizeClass(bytes);
+    if (cls >= 0 && freeLists[cls])
+    {
+        FreeBlock *block = freeLists[cls];
+        freeLists[cls] = block->next;
+        return block;
+    }
+
+    if (bytes > remaining)
+    {
+        size_t size = bytes > SLAB_SIZE ? bytes : SLAB_SIZE;
+        slabs.emplace_back(new char[size]);
+        cursor = slabs.back().get();
+        remaining = size;
+        reserved += size;
+    }
+
+    void *p = cursor;
+    cursor += bytes;
+    remaining -= bytes;
+    return p;
+}
+
+void TrieArena::release(void *p, size_t bytes)
+{
+    if (!p)
+        return;
+    int cls = sizeClass(roundUp(bytes));
+    if (cls < 0)
+        return;
+    FreeBlock *block = static_cast<FreeBlock *>(p);
+    block->next = freeLists[cls];
+    freeLists[cls] = block;
+}
+
+void TrieArena::clear()
+{
+    slabs.clear();
+    cursor = nullptr;
+    remaining = 0;
+    reserved = 0;
+    for (int i = 0; i < SIZE_CLASSES; i++)
+    {
+        classSize[i] = 0;
+        freeLists[i] = nullptr;
+    }
+}
+
+void TrieArena::swap(TrieArena &other)
+{
+    std::swap(slabs, other.slabs);
+    std::swap(cursor, other.cursor);
+    std::swap(remaining, other.remaining);
+    std::swap(reserved, other.reserved);
+    std::swap(classSize, other.classSize);
+    std::swap(freeLists, other.freeLists);
+}
@@ -0,0 +1,49 @@
+#ifndef TRIE_ARENA_H
+#define TRIE_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Vùng nhớ (arena) cho node và danh sách con của Trie. Cấp phát tuần tự
+// trong các slab lớn; khối trả lại được giữ trong free list theo kích thước
+// để dùng lại. Giải phóng cả trie chỉ là thả các slab.
+class TrieArena
+{
+    static const size_t SLAB_SIZE = 64 * 1024;
+    static const size_t ALIGN = alignof(void *);
+    static const int SIZE_CLASSES = 16;
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    vector<unique_ptr<char[]>> slabs;
+    char *cursor = nullptr;
+    size_t remaining = 0;
+    size_t reserved = 0;
+
+    // Free list theo kích thước đã làm tròn (mỗi lớp một kích thước cố định)
+    size_t classSize[SIZE_CLASSES] = {};
+    FreeBlock *freeLists[SIZE_CLASSES] = {};
+
+    static size_t roundUp(size_t bytes) { return (bytes + ALIGN - 1) & ~(ALIGN - 1); }
+    int sizeClass(size_t bytes);
+
+public:
+    TrieArena() = default;
+    TrieArena(const TrieArena &) = delete;
+    TrieArena &operator=(const TrieArena &) = delete;
+
+    void *allocate(size_t bytes);
+    void release(void *p, size_t bytes);
+    void clear();
+    void swap(TrieArena &other);
+
+    size_t bytes() const { return reserved; }
+};
+
+#endif // TRIE_ARENA_H
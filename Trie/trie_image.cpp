@@ -0,0 +1,421 @@
+#include "trie_image.h"
+#include "fuzzy_search.h"
+#include "edit_distance.h"
+#include "levenshtein_automaton.h"
+#include "acronym_index.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace
+{
+    struct ImageEntry
+    {
+        string key; // Chữ thường
+        string spelling;
+        uint32_t weight;
+    };
+
+    struct ImageBuilder
+    {
+        const vector<ImageEntry> &entries;
+        vector<TrieImage::Node> nodes;
+        vector<uint32_t> topK;
+
+        // Node cho các từ [lo, hi) có chung depth ký tự đầu
+        void build(uint32_t lo, uint32_t hi, size_t depth, uint8_t label)
+        {
+            uint32_t index = nodes.size();
+            nodes.push_back({0, lo, hi, TrieImage::NONE, label, 0, 0});
+
+            uint32_t i = lo;
+            if (entries[i].key.size() == depth)
+            {
+                nodes[index].isEnd = 1;
+                i++;
+            }
+            while (i < hi)
+            {
+                char c = entries[i].key[depth];
+                uint32_t j = i;
+                while (j < hi && entries[j].key[depth] == c)
+                    j++;
+                build(i, j, depth + 1, (uint8_t)c);
+                i = j;
+            }
+            nodes[index].subtreeEnd = nodes.size();
+
+            if (hi - lo > TrieImage::K)
+            {
+                vector<uint32_t> ids;
+                for (uint32_t w = lo; w < hi; w++)
+                    ids.push_back(w);
+                partial_sort(ids.begin(), ids.begin() + TrieImage::K, ids.end(),
+                             [this](uint32_t a, uint32_t b)
+                             {
+                                 if (entries[a].weight != entries[b].weight)
+                                     return entries[a].weight > entries[b].weight;
+                                 return a < b;
+                             });
+                nodes[index].topK = topK.size();
+                topK.insert(topK.end(), ids.begin(), ids.begin() + TrieImage::K);
+            }
+        }
+    };
+
+    template <typename T>
+    void writeArray(ofstream &out, const vector<T> &items)
+    {
+        out.write(reinterpret_cast<const char *>(items.data()), items.size() * sizeof(T));
+    }
+
+    string toLower(string_view s)
+    {
+        string result(s);
+        for (char &c : result)
+            c = tolower(c);
+        return result;
+    }
+}
+
+// Duyệt ảnh cùng automaton: mỗi cạnh một lần step, trạng thái chết cắt cả cây con
+struct TrieImage::SimilarWalk
+{
+    const string &input;
+    const Filter &accept;
+    const LevenshteinAutomaton &automaton;
+    int stateSize;
+    vector<uint64_t> states;
+    string path;
+    vector<pair<int, string>> candidates;
+};
+
+bool TrieImage::save(const string &path, vector<pair<string, uint32_t>> entries)
+{
+    vector<ImageEntry> sorted;
+    sorted.reserve(entries.size());
+    for (auto &entry : entries)
+    {
+        if (!entry.first.empty())
+            sorted.push_back({toLower(entry.first), std::move(entry.first), entry.second});
+    }
+    sort(sorted.begin(), sorted.end(),
+         [](const ImageEntry &a, const ImageEntry &b) { return a.key < b.key; });
+
+    // Gộp các cách viết của cùng một từ: giữ cách viết đầu tiên, cộng trọng số
+    size_t unique = 0;
+    for (size_t i = 0; i < sorted.size(); i++)
+    {
+        if (unique > 0 && sorted[unique - 1].key == sorted[i].key)
+            sorted[unique - 1].weight += sorted[i].weight;
+        else if (unique++ != i)
+            sorted[unique - 1] = std::move(sorted[i]);
+    }
+    sorted.resize(unique);
+
+    ImageBuilder builder{sorted, {}, {}};
+    if (sorted.empty())
+        builder.nodes.push_back({1, 0, 0, NONE, 0, 0, 0});
+    else
+        builder.build(0, sorted.size(), 0, 0);
+
+    vector<Word> wordTable;
+    string chars;
+    for (const auto &entry : sorted)
+    {
+        wordTable.push_back({(uint32_t)chars.size(), (uint32_t)entry.spelling.size(), entry.weight});
+        chars += entry.spelling;
+    }
+
+    Header header{MAGIC, VERSION, (uint32_t)builder.nodes.size(), (uint32_t)wordTable.size(),
+                  (uint32_t)builder.topK.size(), (uint32_t)chars.size()};
+
+    // Ghi ra file tạm rồi đổi tên: lần mở sau không thấy ảnh ghi dở
+    string temporary = path + ".tmp";
+    {
+        ofstream out(temporary, ios::binary | ios::trunc);
+        if (!out)
+            return false;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        writeArray(out, builder.nodes);
+        writeArray(out, wordTable);
+        writeArray(out, builder.topK);
+        out.write(chars.data(), chars.size());
+        if (!out)
+            return false;
+    }
+#ifdef _WIN32
+    // rename không ghi đè trên Windows; file đích không được còn bị map
+    return MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+}
+
+shared_ptr<const TrieImage> TrieImage::load(const string &path)
+{
+    shared_ptr<TrieImage> image(new TrieImage());
+    if (!image->file.open(path) || image->file.size() < sizeof(Header))
+        return nullptr;
+
+    const char *base = image->file.data();
+    const Header *header = reinterpret_cast<const Header *>(base);
+    if (header->magic != MAGIC || header->version != VERSION || header->nodeCount == 0)
+        return nullptr;
+
+    // Chỉ kiểm tra kích thước: không chạm vào các trang dữ liệu khi mở
+    size_t expected = sizeof(Header) + (size_t)header->nodeCount * sizeof(Node) +
+                      (size_t)header->wordCount * sizeof(Word) +
+                      (size_t)header->topKCount * sizeof(uint32_t) + header->stringBytes;
+    if (image->file.size() != expected)
+        return nullptr;
+
+    image->header = header;
+    image->nodes = reinterpret_cast<const Node *>(base + sizeof(Header));
+    image->words = reinterpret_cast<const Word *>(image->nodes + header->nodeCount);
+    image->topK = reinterpret_cast<const uint32_t *>(image->words + header->wordCount);
+    image->strings = reinterpret_cast<const char *>(image->topK + header->topKCount);
+
+    if (!image->validNode(0, header->nodeCount) || image->nodes[0].subtreeEnd != header->nodeCount)
+        return nullptr;
+    return image;
+}
+
+bool TrieImage::validSpan(uint32_t i, uint32_t end) const
+{
+    // subtreeEnd > i bảo đảm duyệt con luôn tiến
+    return i < end && nodes[i].subtreeEnd > i && nodes[i].subtreeEnd <= end;
+}
+
+bool TrieImage::validNode(uint32_t i, uint32_t end) const
+{
+    // File hỏng hoặc ghi dở: node có chỉ số ngoài ảnh bị bỏ qua thay vì đọc ra
+    // ngoài vùng map
+    if (!validSpan(i, end))
+        return false;
+    const Node &n = nodes[i];
+    return n.wordBegin <= n.wordEnd && n.wordEnd <= header->wordCount && (!n.isEnd || n.wordBegin < n.wordEnd) &&
+           (n.topK == NONE || (uint64_t)n.topK + K <= header->topKCount);
+}
+
+string_view TrieImage::text(uint32_t wordIndex) const
+{
+    if (wordIndex >= header->wordCount)
+        return {};
+    const Word &w = words[wordIndex];
+    if ((uint64_t)w.offset + w.length > header->stringBytes)
+        return {};
+    return string_view(strings + w.offset, w.length);
+}
+
+uint32_t TrieImage::findNode(const string &prefix) const
+{
+    uint32_t node = 0;
+    for (char c : prefix)
+    {
+        uint8_t label = tolower(c);
+        uint32_t end = nodes[node].subtreeEnd;
+        uint32_t child = node + 1;
+        while (validSpan(child, end) && nodes[child].label < label)
+            child = nodes[child].subtreeEnd;
+        if (!validNode(child, end) || nodes[child].label != label)
+            return NONE;
+        node = child;
+    }
+    return node;
+}
+
+bool TrieImage::contains(const string &word) const
+{
+    uint32_t node = findNode(word);
+    return node != NONE && nodes[node].isEnd && !text(nodes[node].wordBegin).empty();
+}
+
+uint32_t TrieImage::weight(const string &word) const
+{
+    uint32_t node = findNode(word);
+    return (node != NONE && nodes[node].isEnd) ? words[nodes[node].wordBegin].weight : 0;
+}
+
+void TrieImage::rankRange(uint32_t begin, uint32_t end, int limit, const Filter &accept, vector<string> &result) const
+{
+    vector<uint32_t> ids;
+    for (uint32_t w = begin; w < end; w++)
+        ids.push_back(w);
+    auto heavier = [this](uint32_t a, uint32_t b)
+    {
+        if (words[a].weight != words[b].weight)
+            return words[a].weight > words[b].weight;
+        return a < b;
+    };
+
+    // Thường không từ nào bị lọc: chỉ sắp phần đầu, sắp hết khi phải lấy thêm
+    size_t keep = min<size_t>(limit, ids.size());
+    partial_sort(ids.begin(), ids.begin() + keep, ids.end(), heavier);
+    for (size_t i = 0; i < ids.size() && (int)result.size() < limit; i++)
+    {
+        if (i == keep)
+            sort(ids.begin() + keep, ids.end(), heavier);
+        string word(text(ids[i]));
+        if (!word.empty() && (!accept || accept(word)))
+            result.push_back(std::move(word));
+    }
+}
+
+vector<string> TrieImage::findWordsWithPrefix(const string &prefix, int limit, const Filter &accept) const
+{
+    vector<string> result;
+    if (prefix.empty() || limit <= 0)
+        return result;
+
+    uint32_t node = findNode(prefix);
+    if (node == NONE)
+        return result;
+
+    const Node &n = nodes[node];
+    if (n.topK != NONE && (uint32_t)limit <= K)
+    {
+        bool filtered = false;
+        for (uint32_t i = 0; i < K && (int)result.size() < limit; i++)
+        {
+            string word(text(topK[n.topK + i]));
+            if (!word.empty() && (!accept || accept(word)))
+                result.push_back(std::move(word));
+            else
+                filtered = true;
+        }
+        // Top-K còn đủ sau khi lọc; ngược lại xếp hạng cả khoảng
+        if (!filtered || (int)result.size() == limit)
+            return result;
+        result.clear();
+    }
+
+    // Ít từ (hoặc cần nhiều hơn K, hoặc top-K bị lọc mất): xếp hạng cả khoảng
+    rankRange(n.wordBegin, n.wordEnd, limit, accept, result);
+    return result;
+}
+
+vector<string> TrieImage::findWordsByAbbreviation(const string &abbrev, int limit, const Filter &accept) const
+{
+    vector<string> result;
+    vector<pair<size_t, size_t>> query;
+    splitAbbreviation(abbrev, query);
+    if (query.size() < 2 || limit <= 0)
+        return result;
+
+    // Đoạn đầu của truy vấn là tiền tố của từ (từ bắt đầu bằng '_' bị bỏ qua):
+    // chỉ các từ trong khoảng của node đó được kiểm tra, nên chỉ các trang đó được đọc
+    uint32_t node = findNode(abbrev.substr(query[0].first, query[0].second - query[0].first));
+    if (node == NONE)
+        return result;
+
+    // Chặn trên số từ kiểm tra để độ trễ không phụ thuộc kích thước ảnh
+    const uint32_t MAX_CANDIDATES = 16384;
+    uint32_t begin = nodes[node].wordBegin;
+    uint32_t end = begin + min(nodes[node].wordEnd - begin, MAX_CANDIDATES);
+    vector<pair<size_t, size_t>> segments;
+    vector<pair<pair<size_t, size_t>, string>> found; // ((đoạn thừa, độ dài), từ)
+    for (uint32_t w = begin; w < end; w++)
+    {
+        string_view word = text(w);
+        splitIdentifier(word, segments);
+        if (!matchesAbbreviation(abbrev, query, word, segments))
+            continue;
+        string spelling(word);
+        if (!accept || accept(spelling))
+            found.push_back({{segments.size() - query.size(), word.size()}, std::move(spelling)});
+    }
+
+    size_t keep = min<size_t>(limit, found.size());
+    partial_sort(found.begin(), found.begin() + keep, found.end());
+    for (size_t i = 0; i < keep; i++)
+        result.push_back(std::move(found[i].second));
+    return result;
+}
+
+void TrieImage::visitSimilar(SimilarWalk &walk, uint32_t node, int depth) const
+{
+    const uint64_t *state = &walk.states[depth * walk.stateSize];
+
+    int distance = walk.automaton.distance(state);
+    if (nodes[node].isEnd && distance >= 0)
+    {
+        string candidateWord(text(nodes[node].wordBegin));
+        if (!candidateWord.empty() && (!walk.accept || walk.accept(candidateWord)))
+            walk.candidates.push_back({calculateRankingScore(walk.input, walk.path, distance), candidateWord});
+    }
+
+    if ((size_t)(depth + 2) * walk.stateSize > walk.states.size())
+        walk.states.resize((depth + 2) * walk.stateSize);
+
+    uint32_t end = nodes[node].subtreeEnd;
+    for (uint32_t child = node + 1; validSpan(child, end); child = nodes[child].subtreeEnd)
+    {
+        if (!validNode(child, end) ||
+            !walk.automaton.step(&walk.states[depth * walk.stateSize], nodes[child].label,
+                                 &walk.states[(depth + 1) * walk.stateSize]))
+            continue;
+
+        walk.path.push_back(nodes[child].label);
+        visitSimilar(walk, child, depth + 1);
+        walk.path.pop_back();
+    }
+}
+
+vector<string> TrieImage::findSimilarWords(const string &word, int maxSuggestions, const Filter &accept) const
+{
+    if (word.empty() || maxSuggestions <= 0)
+        return {};
+
+    string normalizedInput = toLower(word);
+    int maxDistance = maxEditDistanceFor(normalizedInput.size());
+    vector<pair<int, string>> candidates;
+
+    if (normalizedInput.size() > LevenshteinAutomaton::MAX_PATTERN)
+    {
+        // Quá dài cho automaton: so trực tiếp với từng từ (hiếm)
+        EditDistancePattern pattern(normalizedInput);
+        for (uint32_t w = 0; w < header->wordCount; w++)
+        {
+            string candidateWord(text(w));
+            if (candidateWord.empty())
+                continue;
+            int distance = pattern.distanceTo(candidateWord);
+            if (distance <= maxDistance && (!accept || accept(candidateWord)))
+                candidates.push_back({calculateRankingScore(normalizedInput, toLower(candidateWord), distance),
+                                      candidateWord});
+        }
+    }
+    else
+    {
+        LevenshteinAutomaton automaton(normalizedInput, maxDistance);
+        SimilarWalk walk{normalizedInput, accept, automaton, automaton.stateSize(), {}, {}, {}};
+        walk.states.resize(walk.stateSize * (normalizedInput.size() + maxDistance + 2));
+        automaton.start(walk.states.data());
+        visitSimilar(walk, 0, 0);
+        candidates = std::move(walk.candidates);
+    }
+
+    sort(candidates.begin(), candidates.end());
+
+    vector<string> result;
+    for (int i = 0; i < min(maxSuggestions, (int)candidates.size()); i++)
+        result.push_back(candidates[i].second);
+    return result;
+}
+
+void TrieImage::forEachWord(const function<void(string_view, uint32_t)> &visit) const
+{
+    for (uint32_t w = 0; w < header->wordCount; w++)
+    {
+        string_view word = text(w);
+        if (!word.empty())
+            visit(word, words[w].weight);
+    }
+}
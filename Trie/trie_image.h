@@ -0,0 +1,113 @@
+#ifndef TRIE_IMAGE_H
+#define TRIE_IMAGE_H
+
+#include "mapped_file.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+using namespace std;
+
+// Ảnh trie chỉ đọc, lưu ra file và mmap lại được: không có con trỏ, mọi liên kết
+// là chỉ số nên ảnh dùng được ở bất kỳ địa chỉ nào mà không cần giải mã.
+// Bố cục (little-endian, căn 4 byte):
+//   Header | Node[nodeCount] | Word[wordCount] | uint32_t topK[] | chuỗi
+// Node xếp theo thứ tự duyệt trước (preorder), con tăng dần theo nhãn: cây con
+// của node i là [i, subtreeEnd), con đầu tiên là i + 1. Word xếp theo khóa chữ
+// thường nên các từ có chung tiền tố liền nhau: [wordBegin, wordEnd).
+// Node có nhiều hơn K từ giữ sẵn K từ nặng nhất (giống TopKCache của Trie).
+// Khi mở chỉ kiểm tra header và kích thước các phần; node, từ và top-K được
+// kiểm tra lúc truy vấn chạm tới (node hỏng coi như không có), nên mở file lớn
+// không phải đọc hết các trang.
+class TrieImage
+{
+public:
+    static constexpr uint32_t MAGIC = 0x49545343; // "CSTI"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t K = 10;
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t nodeCount;
+        uint32_t wordCount;
+        uint32_t topKCount;
+        uint32_t stringBytes;
+    };
+
+    struct Node
+    {
+        uint32_t subtreeEnd;
+        uint32_t wordBegin; // Node là cuối từ thì từ đó là wordBegin
+        uint32_t wordEnd;
+        uint32_t topK;      // Vị trí K từ nặng nhất trong mảng topK, hoặc NONE
+        uint8_t label;
+        uint8_t isEnd;
+        uint16_t reserved;
+    };
+
+    struct Word
+    {
+        uint32_t offset;
+        uint32_t length;
+        uint32_t weight;
+    };
+
+    // Ghi ảnh cho danh sách (từ, trọng số); từ trùng khi bỏ hoa thường được gộp
+    static bool save(const string &path, vector<pair<string, uint32_t>> entries);
+    // nullptr nếu file không tồn tại, không phải ảnh hoặc kích thước không khớp header
+    static shared_ptr<const TrieImage> load(const string &path);
+
+    TrieImage(const TrieImage &) = delete;
+    TrieImage &operator=(const TrieImage &) = delete;
+
+    // accept (nếu có) lọc các từ được trả về, vd. bỏ tên đã bị xóa khỏi tài liệu
+    using Filter = function<bool(const string &)>;
+
+    bool contains(const string &word) const;
+    uint32_t weight(const string &word) const;
+    // Xếp theo trọng số như Trie::findWordsWithPrefix
+    vector<string> findWordsWithPrefix(const string &prefix, int limit = 10, const Filter &accept = nullptr) const;
+    // Viết tắt theo ranh giới từ như Trie::findWordsByAbbreviation; chỉ quét các
+    // từ có tiền tố là đoạn đầu của truy vấn
+    vector<string> findWordsByAbbreviation(const string &abbrev, int limit = 10, const Filter &accept = nullptr) const;
+    // Giao automaton Levenshtein với ảnh, xếp hạng bằng calculateRankingScore
+    vector<string> findSimilarWords(const string &word, int maxSuggestions = 5, const Filter &accept = nullptr) const;
+    // Bỏ qua từ có chuỗi nằm ngoài ảnh
+    void forEachWord(const function<void(string_view, uint32_t)> &visit) const;
+
+    size_t size() const { return header->wordCount; }
+    size_t bytes() const { return file.size(); }
+
+private:
+    MappedFile file;
+    const Header *header = nullptr;
+    const Node *nodes = nullptr;
+    const Word *words = nullptr;
+    const uint32_t *topK = nullptr;
+    const char *strings = nullptr;
+
+    TrieImage() = default;
+
+    // Cây con của node i nằm trong [i, end), end là subtreeEnd của node cha:
+    // đủ để bước qua node sang anh em kế tiếp
+    bool validSpan(uint32_t i, uint32_t end) const;
+    // Thêm khoảng từ và top-K nằm trong ảnh: node dùng được
+    bool validNode(uint32_t i, uint32_t end) const;
+    // Node ứng với prefix (không phân biệt hoa thường), NONE nếu không có
+    uint32_t findNode(const string &prefix) const;
+    // Chuỗi của từ; rỗng nếu chỉ số hoặc chuỗi nằm ngoài ảnh
+    string_view text(uint32_t wordIndex) const;
+    // Xếp các từ [begin, end) theo trọng số, lấy tối đa limit từ được accept
+    void rankRange(uint32_t begin, uint32_t end, int limit, const Filter &accept, vector<string> &result) const;
+    // Trạng thái duyệt của findSimilarWords (automaton theo từng độ sâu)
+    struct SimilarWalk;
+    void visitSimilar(SimilarWalk &walk, uint32_t node, int depth) const;
+};
+
+#endif // TRIE_IMAGE_H
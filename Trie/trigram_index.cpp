@@ -0,0 +1,294 @@
+#include "trigram_index.h"
+#include "string_pool.h"
+#include "edit_distance.h"
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+    uint32_t trigramKey(const string &s, size_t i)
+    {
+        return ((uint32_t)(unsigned char)s[i] << 16) | ((uint32_t)(unsigned char)s[i + 1] << 8) |
+               (uint32_t)(unsigned char)s[i + 2];
+    }
+
+    string toLower(string_view s)
+    {
+        string result(s);
+        for (char &c : result)
+            c = tolower(c);
+        return result;
+    }
+
+    // Các trigram khác nhau của s (đã là chữ thường)
+    vector<uint32_t> distinctTrigrams(const string &s)
+    {
+        vector<uint32_t> keys;
+        for (size_t i = 0; i + 3 <= s.size(); i++)
+            keys.push_back(trigramKey(s, i));
+        sort(keys.begin(), keys.end());
+        keys.erase(unique(keys.begin(), keys.end()), keys.end());
+        return keys;
+    }
+
+    bool containsIgnoreCase(string_view word, const string &lowerNeedle)
+    {
+        return search(word.begin(), word.end(), lowerNeedle.begin(), lowerNeedle.end(),
+                      [](char a, char b) { return tolower(a) == b; }) != word.end();
+    }
+}
+
+// ===== PostingList / Cursor =====
+
+void TrigramIndex::PostingList::append(uint32_t id)
+{
+    if (count > 0 && count % SKIP_INTERVAL == 0)
+        skips.push_back({last, (uint32_t)bytes.size()});
+
+    // Varint: 7 bit mỗi byte, bit cao báo còn byte tiếp theo
+    uint32_t delta = id - last;
+    while (delta >= 0x80)
+    {
+        bytes.push_back((uint8_t)(delta | 0x80));
+        delta >>= 7;
+    }
+    bytes.push_back((uint8_t)delta);
+
+    last = id;
+    count++;
+}
+
+void TrigramIndex::Cursor::next()
+{
+    if (index >= list->count)
+    {
+        valid = false;
+        return;
+    }
+
+    uint32_t delta = 0;
+    int shift = 0;
+    uint8_t b;
+    do
+    {
+        b = list->bytes[offset++];
+        delta |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+
+    id += delta;
+    index++;
+    valid = true;
+}
+
+void TrigramIndex::Cursor::advanceTo(uint32_t target)
+{
+    if (!valid || id >= target)
+        return;
+
+    // Khối xa nhất bắt đầu sau một ID < target
+    const auto &skips = list->skips;
+    auto it = lower_bound(skips.begin(), skips.end(), target,
+                          [](const PostingList::Skip &s, uint32_t t) { return s.lastId < t; });
+    if (it != skips.begin())
+    {
+        --it;
+        uint32_t blockStart = (uint32_t)(it - skips.begin() + 1) * SKIP_INTERVAL;
+        if (blockStart >= index)
+        {
+            offset = it->offset;
+            id = it->lastId;
+            index = blockStart;
+            next();
+        }
+    }
+
+    while (valid && id < target)
+        next();
+}
+
+// ===== TrigramIndex =====
+
+int TrigramIndex::lengthBucket(size_t length)
+{
+    static const size_t upper[LENGTH_BUCKETS - 1] = {6, 8, 10, 12, 15, 19, 25};
+    int bucket = 0;
+    while (bucket < LENGTH_BUCKETS - 1 && length > upper[bucket])
+        bucket++;
+    return bucket;
+}
+
+void TrigramIndex::add(uint32_t wordId, string_view word)
+{
+    if (lengths.size() <= wordId)
+        lengths.resize(wordId + 1, 0);
+    lengths[wordId] = (uint8_t)min<size_t>(max<size_t>(word.size(), 1), 255);
+
+    uint32_t bucket = lengthBucket(word.size());
+    for (uint32_t key : distinctTrigrams(toLower(word)))
+        lists[(key << 3) | bucket].append(wordId);
+}
+
+void TrigramIndex::remove(uint32_t wordId)
+{
+    if (wordId < lengths.size())
+        lengths[wordId] = 0;
+}
+
+void TrigramIndex::collectLists(const vector<uint32_t> &trigrams, int bucket,
+                                vector<const PostingList *> &out) const
+{
+    out.clear();
+    for (uint32_t key : trigrams)
+    {
+        auto it = lists.find((key << 3) | bucket);
+        if (it != lists.end())
+            out.push_back(&it->second);
+    }
+    sort(out.begin(), out.end(),
+         [](const PostingList *a, const PostingList *b) { return a->count < b->count; });
+}
+
+void TrigramIndex::findContaining(const string &input, const StringPool &words, size_t limit,
+                                  vector<uint32_t> &out) const
+{
+    out.clear();
+    if (input.size() < 3 || limit == 0)
+        return;
+
+    string needle = toLower(input);
+    vector<uint32_t> trigrams = distinctTrigrams(needle);
+    vector<const PostingList *> postings;
+    vector<Cursor> cursors;
+    vector<pair<uint8_t, uint32_t>> found; // (độ dài, ID)
+
+    for (int bucket = lengthBucket(needle.size()); bucket < LENGTH_BUCKETS && found.size() < limit; bucket++)
+    {
+        collectLists(trigrams, bucket, postings);
+        if (postings.size() < trigrams.size())
+            continue; // Có trigram không xuất hiện trong nhóm này
+
+        // Giao kiểu leapfrog: danh sách ngắn nhất dẫn, các danh sách khác nhảy theo
+        cursors.clear();
+        for (const PostingList *list : postings)
+            cursors.emplace_back(list);
+
+        Cursor &driver = cursors[0];
+        bool exhausted = false;
+        while (driver.ok() && !exhausted && found.size() < limit)
+        {
+            uint32_t id = driver.value();
+            bool match = true;
+            for (size_t i = 1; i < cursors.size(); i++)
+            {
+                cursors[i].advanceTo(id);
+                if (!cursors[i].ok())
+                {
+                    exhausted = true;
+                    match = false;
+                    break;
+                }
+                if (cursors[i].value() != id)
+                {
+                    driver.advanceTo(cursors[i].value());
+                    match = false;
+                    break;
+                }
+            }
+            if (!match)
+                continue;
+
+            // Đủ trigram chưa chắc chứa đoạn con ("abcd" và "abcxbcd"): kiểm tra lại
+            if (lengths[id] != 0 && containsIgnoreCase(words.view(id), needle))
+                found.push_back({lengths[id], id});
+            driver.next();
+        }
+    }
+
+    sort(found.begin(), found.end());
+    for (auto &e : found)
+        out.push_back(e.second);
+}
+
+bool TrigramIndex::findApproximate(const string &input, int maxErrors, const StringPool &words, size_t limit,
+                                   vector<pair<uint32_t, int>> &out) const
+{
+    out.clear();
+    string needle = toLower(input);
+    vector<uint32_t> trigrams = distinctTrigrams(needle);
+
+    int required = 3 * maxErrors + 1;
+    if ((int)trigrams.size() < required)
+        return false;
+
+    static thread_local vector<uint32_t> seen;
+    static thread_local uint32_t generation = 0;
+    static thread_local string candidate;
+    if (seen.size() < lengths.size())
+        seen.resize(lengths.size(), 0);
+    if (++generation == 0)
+    {
+        fill(seen.begin(), seen.end(), 0);
+        generation = 1;
+    }
+
+    // Chặn trên số lần kiểm tra để độ trễ không phụ thuộc kích thước từ điển
+    const int MAX_VERIFY = 4096;
+    int verified = 0;
+
+    EditDistancePattern pattern(needle);
+    vector<const PostingList *> postings;
+    vector<pair<pair<int, uint8_t>, uint32_t>> found; // ((lỗi, độ dài), ID)
+
+    int firstBucket = lengthBucket(needle.size() > (size_t)maxErrors ? needle.size() - maxErrors : 0);
+    for (int bucket = firstBucket; bucket < LENGTH_BUCKETS && found.size() < limit && verified < MAX_VERIFY; bucket++)
+    {
+        collectLists(trigrams, bucket, postings);
+
+        // Trigram không tồn tại là "hiếm nhất" và đã chiếm chỗ trong required
+        int missing = trigrams.size() - postings.size();
+        int take = required - missing;
+
+        for (int i = 0; i < take && verified < MAX_VERIFY && found.size() < limit; i++)
+        {
+            for (Cursor c(postings[i]); c.ok() && verified < MAX_VERIFY && found.size() < limit; c.next())
+            {
+                uint32_t id = c.value();
+                if (seen[id] == generation || lengths[id] == 0)
+                    continue;
+                seen[id] = generation;
+                verified++;
+
+                string_view word = words.view(id);
+                candidate.assign(word.data(), word.size());
+                int errors = pattern.searchIn(candidate);
+                if (errors <= maxErrors)
+                    found.push_back({{errors, lengths[id]}, id});
+            }
+        }
+    }
+
+    size_t keep = min(limit, found.size());
+    partial_sort(found.begin(), found.begin() + keep, found.end());
+    for (size_t i = 0; i < keep; i++)
+        out.push_back({found[i].second, found[i].first.first});
+    return true;
+}
+
+size_t TrigramIndex::bytes() const
+{
+    size_t total = lengths.capacity();
+    for (const auto &entry : lists)
+    {
+        const PostingList &list = entry.second;
+        total += sizeof(entry) + sizeof(void *) + list.bytes.capacity() +
+                 list.skips.capacity() * sizeof(PostingList::Skip);
+    }
+    return total + lists.bucket_count() * sizeof(void *);
+}
+
+void TrigramIndex::clear()
+{
+    lists.clear();
+    lengths.clear();
+}
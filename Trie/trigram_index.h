@@ -0,0 +1,89 @@
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+
+using namespace std;
+
+class StringPool;
+
+// Chỉ mục đảo theo trigram (3 ký tự liên tiếp, chữ thường) cho tìm kiếm đoạn con:
+// "count" tìm ra getCount, row_count... Mỗi (trigram, nhóm độ dài từ) giữ danh
+// sách wordId tăng dần, nén bằng varint của hiệu hai ID liên tiếp, kèm skip
+// pointer mỗi SKIP_INTERVAL phần tử để phép giao nhảy qua các khối không cần
+// giải nén. Truy vấn duyệt nhóm độ dài từ ngắn tới dài và dừng khi đủ kết quả,
+// nên độ trễ không tăng theo kích thước từ điển.
+// Từ bị thay thế/xóa chỉ được đánh dấu (tombstone), danh sách không bị sửa.
+class TrigramIndex
+{
+public:
+    struct PostingList
+    {
+        struct Skip
+        {
+            uint32_t lastId; // ID ngay trước khối
+            uint32_t offset; // Vị trí byte đầu khối
+        };
+
+        vector<uint8_t> bytes;
+        vector<Skip> skips;
+        uint32_t last = 0;
+        uint32_t count = 0;
+
+        void append(uint32_t id);
+    };
+
+    // Con trỏ đọc tuần tự một danh sách đã nén
+    class Cursor
+    {
+        const PostingList *list;
+        size_t offset = 0;
+        uint32_t index = 0;
+        uint32_t id = 0;
+        bool valid = false;
+
+    public:
+        explicit Cursor(const PostingList *l) : list(l) { next(); }
+        bool ok() const { return valid; }
+        uint32_t value() const { return id; }
+        void next();
+        // Tiến tới phần tử đầu tiên >= target
+        void advanceTo(uint32_t target);
+    };
+
+    static constexpr uint32_t SKIP_INTERVAL = 64;
+    static constexpr int LENGTH_BUCKETS = 8;
+
+    void add(uint32_t wordId, string_view word);
+    void remove(uint32_t wordId);
+
+    // Từ chứa input (không phân biệt hoa thường), tối đa limit từ, ưu tiên từ
+    // ngắn (ứng viên tốt nhất theo calculateRankingScore) theo nhóm độ dài.
+    void findContaining(const string &input, const StringPool &words, size_t limit,
+                        vector<uint32_t> &out) const;
+
+    // (wordId, lỗi) của các từ có một đoạn con cách input không quá maxErrors.
+    // Lọc theo số trigram chung: thiếu tối đa 3 * maxErrors trigram, nên mọi kết
+    // quả chứa ít nhất một trong 3 * maxErrors + 1 trigram hiếm nhất của input.
+    // Trả về false nếu input quá ngắn để lọc được với maxErrors lỗi.
+    bool findApproximate(const string &input, int maxErrors, const StringPool &words, size_t limit,
+                         vector<pair<uint32_t, int>> &out) const;
+
+    size_t bytes() const;
+    void clear();
+
+private:
+    unordered_map<uint32_t, PostingList> lists; // Khóa: (trigram << 3) | nhóm độ dài
+    vector<uint8_t> lengths; // wordId -> độ dài (tối đa 255), 0 = đã xóa
+
+    static int lengthBucket(size_t length);
+    // Danh sách có mặt của các trigram trong nhóm bucket, ngắn nhất trước
+    void collectLists(const vector<uint32_t> &trigrams, int bucket, vector<const PostingList *> &out) const;
+};
+
+#endif // TRIGRAM_INDEX_H
@@ -0,0 +1,158 @@
+#include "AnalysisWorker.h"
+#include "../lexer/Lexer.h"
+#include "../parser/Parser.h"
+#include "../parser/semantics.h"
+#include "../preprocessor/preprocessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+AnalysisWorker::AnalysisWorker(const std::atomic<uint64_t> &latestGeneration, ConcurrentDictionary &dictionary)
+    : latestGeneration(latestGeneration), dictionary(dictionary)
+{
+}
+
+// Chẩn đoán thuộc tầng Syntax: lỗi preprocessor, từ vựng và cú pháp
+static bool isSyntaxDiagnostic(const DiagnosticItem &diag)
+{
+    return diag.code == "E0" || diag.code == "E1" || diag.code.rfind("PP-", 0) == 0;
+}
+
+void AnalysisWorker::analyze(uint64_t generation, const std::string &source)
+{
+    // Các yêu cầu cũ còn xếp hàng bị bỏ qua ngay
+    if (isStale(generation))
+        return;
+
+    auto started = std::chrono::steady_clock::now();
+    auto result = std::make_shared<AnalysisResult>();
+    result->generation = generation;
+    result->tier = AnalysisTier::Semantic;
+
+    // Bước 1: Xử lý #include
+    Preprocessor preprocessor;
+    preprocessor.setDiagnosticReporter(&result->diagnostics);
+    std::string processedCode = preprocessor.process(source);
+    for (const auto &lib : preprocessor.getIncludedLibraries())
+        result->includedLibraries.push_back(lib);
+    if (isStale(generation))
+        return;
+
+    // Bước 2: Lexer
+    Lexer lexer(processedCode);
+    lexer.setDiagnosticReporter(&result->diagnostics);
+    std::vector<Token> tokens = lexer.tokenize();
+    if (isStale(generation))
+        return;
+
+    // Bước 3: Một lần parse với Semantics, dừng giữa hai hàm nếu đã có yêu cầu mới.
+    // Lỗi cú pháp (cùng lỗi preprocessor/lexer) được gửi dần thành tầng Syntax ở
+    // ranh giới giữa hai hàm mỗi khi có lỗi mới, không chờ parse hết tài liệu.
+    Parser parser(tokens);
+    semantics sem;
+    sem.sym->setFuzzyEngine(fuzzyEngine);
+    sem.enterScope();
+
+    std::vector<std::string> libIdentifiers = preprocessor.getLibraryIdentifiers();
+    for (const auto &ident : libIdentifiers)
+        sem.LibraryFunction(ident);
+
+    // Chỉ xét chẩn đoán mới ở mỗi ranh giới; gửi lại khi số lỗi tầng Syntax tăng
+    size_t scanned = 0, syntaxCount = 0, published = 0;
+    bool anyPublished = false;
+    auto publishSyntax = [&](bool final)
+    {
+        const auto &items = result->diagnostics.all();
+        for (; scanned < items.size(); scanned++)
+        {
+            if (isSyntaxDiagnostic(items[scanned]))
+                syntaxCount++;
+        }
+        // Lần cuối vẫn gửi nếu chưa gửi lần nào: tầng Syntax không lỗi xóa chẩn đoán cũ
+        if (syntaxCount == published && (anyPublished || !final))
+            return;
+        published = syntaxCount;
+        anyPublished = true;
+
+        auto partial = std::make_shared<AnalysisResult>();
+        partial->generation = generation;
+        partial->tier = AnalysisTier::Syntax;
+        partial->includedLibraries = result->includedLibraries;
+        for (const auto &diag : items)
+        {
+            if (isSyntaxDiagnostic(diag))
+                partial->diagnostics.add(diag.severity, diag.code, diag.message, diag.line, diag.col, diag.length);
+        }
+        emit finished(partial);
+    };
+
+    parser.setSemantics(&sem);
+    parser.setDiagnosticReporter(&result->diagnostics);
+    parser.setCancelCheck([this, generation]
+                          { return isStale(generation); });
+    parser.setBoundaryCallback([&]
+                               { publishSyntax(false); });
+    parser.parseProgram();
+    if (parser.wasCancelled() || isStale(generation))
+        return;
+    publishSyntax(true);
+
+    result->timeline = sem.sym->timeline();
+    result->symbols = sem.sym;
+
+    // Cập nhật dictionary ngay trên luồng này: completion đọc bản đã công bố
+    updateDictionary(tokens, preprocessor.getIncludedLibraries());
+
+    result->elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    emit finished(result);
+}
+
+std::shared_ptr<AnalysisResult> AnalysisWorker::analyzeLexical(const std::string &region, int firstLine, bool inComment)
+{
+    auto result = std::make_shared<AnalysisResult>();
+    result->tier = AnalysisTier::Lexical;
+    result->firstLine = firstLine;
+    result->lastLine = firstLine + (int)std::count(region.begin(), region.end(), '\n') - 1;
+
+    // Đoạn bắt đầu giữa chú thích khối: mở lại chú thích để lexer không đọc nhầm
+    // phần chú thích thành mã; cột của dòng đầu được trừ lại phần đã thêm
+    const std::string opener = inComment ? "/*" : "";
+    std::string text = opener + region;
+
+    DiagnosticReporter lexical;
+    Lexer lexer(text);
+    lexer.setDiagnosticReporter(&lexical);
+    lexer.tokenize();
+
+    for (const auto &diag : lexical.all())
+    {
+        int col = diag.line == 1 ? diag.col - (int)opener.size() : diag.col;
+        result->diagnostics.add(diag.severity, diag.code, diag.message, diag.line + firstLine - 1, col, diag.length);
+    }
+    return result;
+}
+
+void AnalysisWorker::updateDictionary(const std::vector<Token> &tokens,
+                                      const std::unordered_set<std::string> &libraries)
+{
+    // Đếm identifiers từ token của lần kiểm tra (không lex lại tài liệu)
+    std::unordered_map<std::string, int> counts;
+    for (const auto &token : tokens)
+    {
+        if (token.type == TokenType::Identifier)
+            counts[token.value]++;
+    }
+
+    // Ghim theo từng thư viện để bỏ #include thì identifiers của nó được nhả
+    std::unordered_map<std::string, std::vector<std::string>> libraryIdentifiers;
+    for (const auto &lib : libraries)
+        libraryIdentifiers[lib] = Preprocessor::getLibraryIdentifiers(lib);
+
+    // Chỉ phần chênh lệch so với lần trước chạm vào trie: tên mới được thêm,
+    // tên không còn xuất hiện bị xóa. Cả lô được công bố một lần.
+    dictionary.update([&](CompletionDictionary &d)
+                      {
+        d.setLibraries(libraryIdentifiers);
+        d.applyCounts(counts); });
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "../lexer/Token.h"
+#include "../Diagnostic/DiagnosticReporter.h"
+#include "../symboltable/symboltable.h"
+#include "../Trie/concurrent_dictionary.h"
+
+#include <QObject>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Các tầng phân tích: tầng sau thay thế chẩn đoán của tầng trước
+enum class AnalysisTier
+{
+    Lexical = 0,  // Chỉ lexer, vùng đang hiển thị, chạy mỗi lần gõ trên luồng UI
+    Syntax = 1,   // Lỗi preprocessor/lexer/parser, gửi dần trong lúc parse
+    Semantic = 2, // Đầy đủ: semantics, gợi ý, cập nhật dictionary
+};
+
+// Kết quả một tầng phân tích, chuyển nguyên khối sang luồng UI
+struct AnalysisResult
+{
+    uint64_t generation = 0;
+    AnalysisTier tier = AnalysisTier::Semantic;
+    DiagnosticReporter diagnostics;
+    std::vector<std::string> includedLibraries;
+    std::shared_ptr<const SymbolTimeline> timeline;
+    // Tầng Semantic: bảng giải gợi ý hoãn lại cho diagnostics (đọc thống kê cache)
+    std::shared_ptr<const SymbolTable> symbols;
+    // Thời gian toàn bộ pipeline (ms), dùng để chọn thời gian chờ tự kiểm tra
+    double elapsedMs = 0;
+    // Tầng Lexical: các dòng đã được lex (chẩn đoán E0 ngoài vùng này giữ nguyên)
+    int firstLine = 0;
+    int lastLine = 0;
+};
+
+// Chạy preprocessor -> lexer -> parser/semantics trên luồng riêng, từ bản sao
+// bất biến của tài liệu. Chỉ parse một lần: lỗi cú pháp được gửi dần thành tầng
+// Syntax trong lúc parse, tầng Semantic gửi sau với cùng generation. Mỗi yêu cầu
+// mang một generation; khi MainWindow tăng
+// generation (gõ thêm, kiểm tra lại), lần chạy cũ tự dừng ở ranh giới pha
+// hoặc giữa hai hàm và không gửi kết quả.
+class AnalysisWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    AnalysisWorker(const std::atomic<uint64_t> &latestGeneration, ConcurrentDictionary &dictionary);
+
+    // Chạy trên luồng của worker (gọi qua QMetaObject::invokeMethod)
+    void analyze(uint64_t generation, const std::string &source);
+    // Engine fuzzy cho gợi ý "did you mean" của các lần phân tích sau
+    void setFuzzyEngine(FuzzyEngine engine) { fuzzyEngine = engine; }
+    // Mọi thay đổi dictionary đi qua luồng này: luồng UI chỉ xếp hàng, không
+    // bao giờ chờ khóa ghi trong lúc worker đang áp một lô lớn
+    void applyDictionaryUpdate(const std::function<void(CompletionDictionary &)> &batch) { dictionary.update(batch); }
+
+    // Tầng Lexical: lex các dòng [firstLine, ...] của đoạn văn bản, báo lỗi theo số dòng
+    // của tài liệu. inComment: đoạn bắt đầu bên trong chú thích khối
+    static std::shared_ptr<AnalysisResult> analyzeLexical(const std::string &region, int firstLine, bool inComment);
+
+signals:
+    void finished(std::shared_ptr<AnalysisResult> result);
+
+private:
+    bool isStale(uint64_t generation) const { return latestGeneration.load() != generation; }
+    void updateDictionary(const std::vector<Token> &tokens, const std::unordered_set<std::string> &libraries);
+
+    const std::atomic<uint64_t> &latestGeneration;
+    ConcurrentDictionary &dictionary;
+    FuzzyEngine fuzzyEngine = FuzzyEngine::Automaton;
+};
+
+Q_DECLARE_METATYPE(std::shared_ptr<AnalysisResult>)
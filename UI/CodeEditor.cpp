@@ -2,6 +2,9 @@
 #include "SuggestionWidget.h"
 #include <QAbstractItemView>
 #include <QScrollBar>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <algorithm>
 
 CodeEditor::CodeEditor(QWidget *parent)
     : QPlainTextEdit(parent)
@@ -75,6 +78,8 @@ void CodeEditor::insertSuggestion(const QString &text)
 
     hideSuggestions();
     setFocus();
+
+    emit suggestionAccepted(text);
 }
 
 QString CodeEditor::textUnderCursor() const
@@ -186,28 +191,89 @@ void CodeEditor::keyPressEvent(QKeyEvent *e)
     // Trigger suggestion sẽ được xử lý bởi MainWindow qua signal textChanged
 }
 
-void CodeEditor::highlightLine(int line, int col, int length, const QColor &color)
+void CodeEditor::highlightLine(int line, int col, int length, const QColor &color, int tag)
 {
-    highlights.push_back({line, col, length, color});
+    QTextBlock block = document()->findBlockByNumber(line - 1);
+    if (!block.isValid())
+        return;
+
+    int textLength = block.length() - 1;
+    int start = qBound(0, col - 1, textLength);
+    int end = qBound(start, col - 1 + length, textLength);
+    // Chẩn đoán độ dài 0 (vd. thiếu ';' ở cuối dòng) vẫn cần một ô nhìn thấy được
+    if (start == end)
+    {
+        if (end < textLength)
+            end++;
+        else if (start > 0)
+            start--;
+    }
 
-    QTextCursor cursor(document()->findBlockByLineNumber(line - 1));
-    cursor.movePosition(QTextCursor::Right, QTextCursor::MoveAnchor, col - 1);
-    cursor.movePosition(QTextCursor::Right, QTextCursor::KeepAnchor, length);
+    Highlight h;
+    h.selection.cursor = QTextCursor(block);
+    h.selection.cursor.setPosition(block.position() + start);
+    h.selection.cursor.setPosition(block.position() + end, QTextCursor::KeepAnchor);
+    h.selection.format.setBackground(color);
+    h.tag = tag;
 
-    QTextCharFormat fmt;
-    fmt.setBackground(color);
-    cursor.setCharFormat(fmt);
+    // Chẩn đoán thường đến theo thứ tự vị trí nên phần lớn là chèn vào cuối
+    auto pos = std::upper_bound(highlights.begin(), highlights.end(), h,
+                                [](const Highlight &a, const Highlight &b)
+                                { return a.selection.cursor.selectionStart() < b.selection.cursor.selectionStart(); });
+    highlights.insert(pos, h);
+
+    if (!highlightsPending)
+    {
+        highlightsPending = true;
+        QMetaObject::invokeMethod(this, &CodeEditor::applyHighlights, Qt::QueuedConnection);
+    }
 }
 
 void CodeEditor::clearHighlights()
 {
     highlights.clear();
+    highlightsPending = false;
+    setExtraSelections({});
+}
 
-    QTextCursor cursor(document());
-    cursor.select(QTextCursor::Document);
-    QTextCharFormat fmt;
-    fmt.setBackground(Qt::white);
-    cursor.setCharFormat(fmt);
+void CodeEditor::applyHighlights()
+{
+    if (!highlightsPending)
+        return;
+    highlightsPending = false;
+
+    QList<QTextEdit::ExtraSelection> selections;
+    selections.reserve((int)highlights.size());
+    for (const auto &h : highlights)
+        selections.append(h.selection);
+    setExtraSelections(selections);
+}
+
+bool CodeEditor::viewportEvent(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip)
+    {
+        QHelpEvent *help = static_cast<QHelpEvent *>(event);
+        QTextCursor cursor = cursorForPosition(help->pos());
+        int position = cursor.position();
+
+        // Chỉ các vùng bắt đầu trên dòng dưới chuột
+        auto it = std::lower_bound(highlights.begin(), highlights.end(), cursor.block().position(),
+                                   [](const Highlight &h, int position)
+                                   { return h.selection.cursor.selectionStart() < position; });
+        for (; it != highlights.end() && it->selection.cursor.selectionStart() <= position; ++it)
+        {
+            if (it->tag >= 0 && position <= it->selection.cursor.selectionEnd())
+            {
+                emit highlightHovered(it->tag, help->globalPos());
+                return true;
+            }
+        }
+        QToolTip::hideText();
+        event->ignore();
+        return true;
+    }
+    return QPlainTextEdit::viewportEvent(event);
 }
 
 // Line number area
@@ -20,17 +20,28 @@ public:
     void showSuggestions(const QStringList &suggestions, const QString &prefix);
     void hideSuggestions();
 
-    void highlightLine(int line, int col, int length, const QColor &color);
+    // Highlight là extra selection: không sửa định dạng của tài liệu (không phát
+    // tín hiệu thay đổi, không vào undo stack), vẽ dưới chữ và di chuyển theo
+    // văn bản khi sửa. col/length tính theo ký tự của editor.
+    // tag: dữ liệu của người gọi (vd. chỉ số chẩn đoán), gửi lại qua highlightHovered
+    void highlightLine(int line, int col, int length, const QColor &color, int tag = -1);
     void clearHighlights();
 
     void lineNumberAreaPaintEvent(QPaintEvent *event);
     int lineNumberAreaWidth();
 
+signals:
+    // Người dùng đã chọn một gợi ý (dùng để tăng trọng số của từ)
+    void suggestionAccepted(const QString &text);
+    // Chuột dừng trên một vùng highlight có tag (dùng để hiện tooltip chẩn đoán)
+    void highlightHovered(int tag, const QPoint &globalPos);
+
 protected:
     void keyPressEvent(QKeyEvent *e) override;
     void focusInEvent(QFocusEvent *e) override;
     void resizeEvent(QResizeEvent *event) override;
     void focusOutEvent(QFocusEvent *e) override;
+    bool viewportEvent(QEvent *event) override;
 
 private slots:
     void insertSuggestion(const QString &text);
@@ -46,12 +57,16 @@ private:
 
     struct Highlight
     {
-        int line;
-        int col;
-        int length;
-        QColor color;
+        QTextEdit::ExtraSelection selection; // cursor tự dời theo các lần sửa
+        int tag;
     };
+    // Sắp xếp theo vị trí đầu vùng; sửa văn bản không đổi thứ tự nên tra tooltip
+    // vẫn tìm nhị phân được
     std::vector<Highlight> highlights;
+    // Nhiều highlightLine liên tiếp chỉ gửi danh sách cho editor một lần
+    bool highlightsPending = false;
+
+    void applyHighlights();
 };
 
 // Line number area widget
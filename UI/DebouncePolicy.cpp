@@ -0,0 +1,33 @@
+#include "DebouncePolicy.h"
+#include <algorithm>
+
+void DebouncePolicy::recordCheck(double elapsedMs)
+{
+    lastCheck = elapsedMs;
+    checkMs = hasCheck ? ALPHA * elapsedMs + (1 - ALPHA) * checkMs : elapsedMs;
+    hasCheck = true;
+}
+
+void DebouncePolicy::recordKeystroke(double nowMs)
+{
+    if (lastKeystroke >= 0)
+    {
+        double gap = nowMs - lastKeystroke;
+        if (gap < PAUSE_MS)
+        {
+            keystrokeGapMs = hasGap ? ALPHA * gap + (1 - ALPHA) * keystrokeGapMs : gap;
+            hasGap = true;
+        }
+    }
+    lastKeystroke = nowMs;
+}
+
+int DebouncePolicy::delayMs() const
+{
+    // Kiểm tra tốn T ms thì chờ khoảng 2T: phần lớn thời gian máy vẫn rảnh cho việc gõ
+    double delay = 2 * checkMs;
+    // Đang gõ đều tay: chờ hơn một nhịp gõ để lần kiểm tra rơi vào lúc dừng
+    if (hasGap)
+        delay = std::max(delay, 1.5 * keystrokeGapMs);
+    return (int)std::clamp(delay, (double)MIN_DELAY_MS, (double)MAX_DELAY_MS);
+}
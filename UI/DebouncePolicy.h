@@ -0,0 +1,34 @@
+#pragma once
+
+// Chọn thời gian chờ trước khi tự kiểm tra từ độ trễ đo được: trung bình trượt
+// (EMA) của thời gian các lần kiểm tra gần đây và của khoảng cách giữa hai lần
+// gõ phím. File nhỏ được kiểm tra gần như ngay, file lớn chờ lâu hơn; khi đang
+// gõ liên tục thì đợi qua một nhịp gõ để không kiểm tra giữa chừng.
+class DebouncePolicy
+{
+public:
+    static constexpr int MIN_DELAY_MS = 150;
+    static constexpr int MAX_DELAY_MS = 3000;
+
+    // Thời gian một lần kiểm tra hoàn tất
+    void recordCheck(double elapsedMs);
+    // Thời điểm gõ phím (ms, đồng hồ đơn điệu)
+    void recordKeystroke(double nowMs);
+
+    int delayMs() const;
+    double averageCheckMs() const { return checkMs; }
+    double lastCheckMs() const { return lastCheck; }
+
+private:
+    static constexpr double ALPHA = 0.3;
+    // Khoảng lặng dài hơn là người dùng đã dừng gõ, không tính vào nhịp gõ
+    static constexpr double PAUSE_MS = 2000;
+
+    double checkMs = 0;
+    double lastCheck = 0;
+    bool hasCheck = false;
+
+    double keystrokeGapMs = 0;
+    double lastKeystroke = -1;
+    bool hasGap = false;
+};
@@ -1,7 +1,6 @@
 #include "MainWindow.h"
 #include "SyntaxHighlighter.h"
 #include "../parser/semantics.h"
-#include "../preprocessor/preprocessor.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -10,21 +9,50 @@
 #include <QGuiApplication>
 #include <QMessageBox>
 #include <QTextBlock>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFileInfo>
+#include <QScrollBar>
+#include <QToolTip>
 
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
 {
     setupUI();
     setupConnections();
-    populateDictionary();
     setMinimumSize(1000, 700);
     // Setup auto-check timer
     autoCheckTimer = new QTimer(this);
     autoCheckTimer->setSingleShot(true);
     connect(autoCheckTimer, &QTimer::timeout, this, &MainWindow::performAutoCheck);
+    typingClock.start();
+    updateTimingLabel();
+
+    // Worker phân tích sống trên luồng riêng suốt vòng đời cửa sổ
+    qRegisterMetaType<std::shared_ptr<AnalysisResult>>();
+    analysisThread = new QThread(this);
+    analysisWorker = new AnalysisWorker(analysisGeneration, dictionary);
+    analysisWorker->moveToThread(analysisThread);
+    connect(analysisThread, &QThread::finished, analysisWorker, &QObject::deleteLater);
+    connect(analysisWorker, &AnalysisWorker::finished, this, &MainWindow::onAnalysisFinished);
+    analysisThread->start();
+
+    populateDictionary();
+    loadDictionaryImage();
 }
 
-MainWindow::~MainWindow() {}
+MainWindow::~MainWindow()
+{
+    // Lần chạy dở dừng ở ranh giới gần nhất, sau đó luồng mới thoát được
+    cancelAnalysis();
+    // Ghi ảnh trên luồng worker, sau các thay đổi dictionary còn xếp hàng
+    QMetaObject::invokeMethod(
+        analysisWorker, [this]
+        { saveDictionaryImage(); },
+        Qt::BlockingQueuedConnection);
+    analysisThread->quit();
+    analysisThread->wait();
+}
 
 void MainWindow::setupUI()
 {
@@ -81,9 +109,18 @@ void MainWindow::setupUI()
     autoCheckBox->setChecked(true);
     autoCheckBox->setStyleSheet("font-size: 13px; padding: 5px;");
 
+    // Engine tìm gợi ý "did you mean"
+    fuzzyEngineBox = new QComboBox(this);
+    fuzzyEngineBox->addItem("Gợi ý: Automaton", (int)FuzzyEngine::Automaton);
+    fuzzyEngineBox->addItem("Gợi ý: A*", (int)FuzzyEngine::AStar);
+    fuzzyEngineBox->addItem("Gợi ý: Levenshtein DP", (int)FuzzyEngine::Levenshtein);
+    fuzzyEngineBox->addItem("Gợi ý: SymSpell", (int)FuzzyEngine::SymSpell);
+    fuzzyEngineBox->setStyleSheet("font-size: 13px; padding: 3px;");
+
     buttonLayout->addWidget(clearButton);
     buttonLayout->addWidget(checkButton);
     buttonLayout->addWidget(autoCheckBox);
+    buttonLayout->addWidget(fuzzyEngineBox);
     buttonLayout->addStretch();
 
     mainLayout->addLayout(buttonLayout);
@@ -152,7 +189,19 @@ void MainWindow::setupUI()
         "  border-radius: 3px;"
         "  font-size: 12px;"
         "}");
-    mainLayout->addWidget(statusLabel);
+
+    timingLabel = new QLabel(this);
+    timingLabel->setStyleSheet(
+        "QLabel {"
+        "  padding: 5px;"
+        "  color: #757575;"
+        "  font-size: 12px;"
+        "}");
+
+    QHBoxLayout *statusLayout = new QHBoxLayout();
+    statusLayout->addWidget(statusLabel, 1);
+    statusLayout->addWidget(timingLabel);
+    mainLayout->addLayout(statusLayout);
 
     // Sample code
     codeEditor->setPlainText(
@@ -170,6 +219,12 @@ void MainWindow::setupConnections()
     connect(codeEditor, &QPlainTextEdit::cursorPositionChanged, this, &MainWindow::onCursorPositionChanged);
     connect(diagnosticList, &QListWidget::itemClicked, this, &MainWindow::onDiagnosticItemClicked);
     connect(autoCheckBox, &QCheckBox::stateChanged, this, &MainWindow::onAutoCheckToggled);
+    connect(fuzzyEngineBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onFuzzyEngineChanged);
+    connect(codeEditor, &CodeEditor::suggestionAccepted, this, &MainWindow::onSuggestionAccepted);
+    connect(codeEditor, &CodeEditor::highlightHovered, this, &MainWindow::onHighlightHovered);
+    connect(diagnosticList->verticalScrollBar(), &QScrollBar::valueChanged,
+            this, &MainWindow::resolveVisibleDiagnostics);
 }
 
 void MainWindow::populateDictionary()
@@ -179,29 +234,60 @@ void MainWindow::populateDictionary()
                 "main", "printf", "scanf", "struct", "typedef",
                 "break", "continue", "switch", "case", "default", "include"};
 
-    // Thêm keywords vào dictionary
-    for (const auto &kw : keywords)
-        dictionary.insert(kw);
+    // Đặt lại dictionary chỉ còn keywords (ghim: không bị xóa khi không còn trong mã),
+    // công bố trong một lô nên completion không thấy trạng thái rỗng ở giữa
+    queueDictionaryUpdate([kws = keywords](CompletionDictionary &d)
+                          {
+        d.clear();
+        for (const auto &kw : kws)
+            d.pin(kw); });
 }
 
-void MainWindow::updateDictionaryFromCode()
+void MainWindow::queueDictionaryUpdate(std::function<void(CompletionDictionary &)> batch)
 {
-    // Lấy tất cả text từ editor
-    QString code = codeEditor->toPlainText();
-    std::string srcCode = code.toStdString();
+    AnalysisWorker *worker = analysisWorker;
+    QMetaObject::invokeMethod(
+        worker, [worker, batch]
+        { worker->applyDictionaryUpdate(batch); },
+        Qt::QueuedConnection);
+}
+
+QString MainWindow::dictionaryImagePath() const
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return QDir(dir).filePath("dictionary.img");
+}
 
-    // Tokenize để lấy tất cả identifiers
-    Lexer lexer(srcCode);
-    std::vector<Token> tokens = lexer.tokenize();
+void MainWindow::loadDictionaryImage()
+{
+    // Ảnh được mmap: chỉ đọc header, các trang còn lại nạp khi truy vấn chạm tới
+    std::shared_ptr<const TrieImage> image = TrieImage::load(dictionaryImagePath().toStdString());
+    if (!image)
+        return;
+    queueDictionaryUpdate([image](CompletionDictionary &d)
+                          { d.setBaseImage(image); });
+}
 
-    // Thêm tất cả identifiers vào dictionary
-    for (const auto &token : tokens)
-    {
-        if (token.type == TokenType::Identifier)
-        {
-            dictionary.insert(token.value);
-        }
-    }
+void MainWindow::saveDictionaryImage()
+{
+    // Gọi trên luồng worker (từ destructor), nơi dictionary được ghi
+    QString path = dictionaryImagePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    auto entries = dictionary.read([](const CompletionDictionary &d)
+                                   { return d.imageEntries(); });
+    // Nhả ảnh nền đang mmap trước khi thay file (Windows không cho thay file đang map)
+    dictionary.update([](CompletionDictionary &d)
+                      { d.setBaseImage(nullptr); });
+    TrieImage::save(path.toStdString(), std::move(entries));
+}
+
+void MainWindow::onSuggestionAccepted(const QString &text)
+{
+    // Gợi ý được chọn có giá trị hơn một lần xuất hiện trong mã
+    const uint32_t ACCEPTED_WEIGHT = 5;
+    std::string word = text.toStdString();
+    queueDictionaryUpdate([word](CompletionDictionary &d)
+                          { d.addWeight(word, ACCEPTED_WEIGHT); });
 }
 
 void MainWindow::updateSuggestions()
@@ -218,14 +304,60 @@ void MainWindow::updateSuggestions()
 
     // Tìm các từ có prefix khớp
     std::string prefix = word.toStdString();
-    std::vector<std::string> suggestions = dictionary.findWordsWithPrefix(prefix);
+    std::vector<std::string> suggestions, abbreviations, containing, similar;
+    dictionary.read([&](const CompletionDictionary &d)
+                    {
+        suggestions = d.findWordsWithPrefix(prefix);
+        abbreviations = d.findWordsByAbbreviation(prefix, 5);
+        containing = d.findWordsContaining(prefix, 5);
+        // Không khớp cách nào: có thể gõ sai ("pirntf" -> printf)
+        if (suggestions.empty() && abbreviations.empty() && containing.empty())
+            similar = d.findSimilarWords(prefix, 5); });
 
     // Chuyển đổi sang QStringList
     QStringList suggestionList;
+
+    // Ưu tiên các symbol nhìn thấy được tại vị trí con trỏ
+    std::shared_ptr<const SymbolTimeline> timeline = visibleSymbols;
+    if (timeline)
+    {
+        QTextCursor pos = codeEditor->textCursor();
+        SymbolSnapshot scope = timeline->visibleAt(pos.blockNumber() + 1, sourceColumn(pos.block(), pos.positionInBlock()));
+        scope.forEach([&](const str_Symbol &sym)
+                      {
+            QString name = QString::fromStdString(sym.name);
+            if (name != word && name.startsWith(word, Qt::CaseInsensitive))
+                suggestionList << name; });
+    }
+
     for (const auto &s : suggestions)
     {
-        if (s != prefix)
-            suggestionList << QString::fromStdString(s);
+        QString name = QString::fromStdString(s);
+        if (s != prefix && !suggestionList.contains(name))
+            suggestionList << name;
+    }
+
+    // Viết tắt theo ranh giới từ (vd. "gcc" -> getCharCount, "rbs" -> read_buffer_size)
+    for (const auto &s : abbreviations)
+    {
+        QString name = QString::fromStdString(s);
+        if (s != prefix && !suggestionList.contains(name, Qt::CaseInsensitive))
+            suggestionList << name;
+    }
+
+    // Sau đó là các từ chứa word ở giữa (vd. "Count" -> getCount, row_count)
+    for (const auto &s : containing)
+    {
+        QString name = QString::fromStdString(s);
+        if (s != prefix && !suggestionList.contains(name, Qt::CaseInsensitive))
+            suggestionList << name;
+    }
+
+    for (const auto &s : similar)
+    {
+        QString name = QString::fromStdString(s);
+        if (s != prefix && !suggestionList.contains(name, Qt::CaseInsensitive))
+            suggestionList << name;
     }
 
     if (!suggestionList.isEmpty())
@@ -240,11 +372,18 @@ void MainWindow::updateSuggestions()
 
 void MainWindow::performAutoCheck()
 {
-    // Kiểm tra nếu code rỗng hoặc quá ngắn thì không check
-    QString code = codeEditor->toPlainText().trimmed();
-    if (code.isEmpty() || code.length() < 10)
+    // Kiểm tra nếu code rỗng hoặc quá ngắn thì không check. Văn bản gửi đi không
+    // được trim: dòng/cột của chẩn đoán và timeline phải khớp với editor
+    QString code = codeEditor->toPlainText();
+    QString trimmed = code.trimmed();
+    if (trimmed.isEmpty() || trimmed.length() < 10)
     {
+        cancelAnalysis();
         diagnosticList->clear();
+        diagnostics.clear();
+        includedLibraries.clear();
+        suggestionSymbols.reset();
+        updateTimingLabel();
         codeEditor->clearHighlights();
         statusLabel->setText("Sẵn sàng");
         statusLabel->setStyleSheet(
@@ -257,20 +396,112 @@ void MainWindow::performAutoCheck()
         return;
     }
 
-    // Thực hiện kiểm tra
-    diagnostics.clear();
-    diagnosticList->clear();
-    codeEditor->clearHighlights();
-
+    // Thực hiện kiểm tra trên worker với bản sao của tài liệu; kết quả cũ vẫn
+    // được hiển thị cho tới khi kết quả mới về
+    uint64_t generation = ++analysisGeneration;
     std::string srcCode = code.toStdString();
+    statusLabel->setText("Đang kiểm tra...");
+    AnalysisWorker *worker = analysisWorker;
+    QMetaObject::invokeMethod(
+        worker, [worker, generation, srcCode]
+        { worker->analyze(generation, srcCode); },
+        Qt::QueuedConnection);
+}
 
-    // Bước 1: Xử lý #include
-    Preprocessor preprocessor;
-    preprocessor.setDiagnosticReporter(&diagnostics);
-    std::string processedCode = preprocessor.process(srcCode);
+int MainWindow::sourceColumn(const QTextBlock &block, int positionInBlock)
+{
+    // Lexer đếm cột theo byte UTF-8 của tài liệu, editor theo đơn vị UTF-16
+    return block.text().left(positionInBlock).toUtf8().size() + 1;
+}
+
+int MainWindow::editorColumn(const QTextBlock &block, int sourceCol)
+{
+    // Đi theo từng ký tự (cặp surrogate là một) cho tới khi đủ số byte UTF-8
+    QString text = block.text();
+    int bytes = 0;
+    int i = 0;
+    while (i < text.size() && bytes < sourceCol - 1)
+    {
+        int units = text[i].isHighSurrogate() && i + 1 < text.size() ? 2 : 1;
+        bytes += text.mid(i, units).toUtf8().size();
+        i += units;
+    }
+    return i + 1;
+}
+
+void MainWindow::runLexicalTier()
+{
+    QTextBlock first = codeEditor->cursorForPosition(QPoint(0, 0)).block();
+    QTextBlock last = codeEditor->cursorForPosition(QPoint(0, codeEditor->viewport()->height() - 1)).block();
+
+    std::string region;
+    for (QTextBlock block = first; block.isValid(); block = block.next())
+    {
+        region += block.text().toStdString();
+        region += '\n';
+        if (block == last)
+            break;
+    }
+    // Trạng thái 1 của SyntaxHighlighter: dòng trước kết thúc giữa chú thích khối
+    bool inComment = first.previous().isValid() && first.previous().userState() == 1;
+
+    auto result = AnalysisWorker::analyzeLexical(region, first.blockNumber() + 1, inComment);
+    result->generation = analysisGeneration.load();
+    onAnalysisFinished(result);
+}
+
+void MainWindow::cancelAnalysis()
+{
+    analysisGeneration++;
+}
+
+void MainWindow::updateTimingLabel()
+{
+    QString text = QString("Chờ %1 ms").arg(debounce.delayMs());
+    if (debounce.lastCheckMs() > 0)
+        text += QString(" · Lần kiểm tra cuối: %1 ms").arg(debounce.lastCheckMs(), 0, 'f', 1);
+    if (suggestionSymbols)
+    {
+        const SuggestionCacheStats &stats = suggestionSymbols->suggestionCacheStats();
+        if (stats.hits + stats.misses > 0)
+            text += QString(" · Cache gợi ý: %1% trúng (%2/%3)")
+                        .arg(stats.hitRate() * 100, 0, 'f', 0)
+                        .arg(stats.hits)
+                        .arg(stats.hits + stats.misses);
+    }
+    timingLabel->setText(text);
+}
+
+void MainWindow::onAnalysisFinished(std::shared_ptr<AnalysisResult> result)
+{
+    if (result->generation != analysisGeneration.load())
+        return; // Tài liệu đã đổi từ khi yêu cầu được gửi
+
+    bool complete = result->tier == AnalysisTier::Semantic;
+    if (complete)
+    {
+        debounce.recordCheck(result->elapsedMs);
+        suggestionSymbols = result->symbols;
+        updateTimingLabel();
+        visibleSymbols = result->timeline;
+    }
+
+    if (result->tier == AnalysisTier::Lexical)
+    {
+        // Chỉ thay lỗi từ vựng của vùng vừa lex; lỗi cú pháp/ngữ nghĩa của lần
+        // kiểm tra trước được giữ tới khi tầng sau về
+        diagnostics.replaceInLines("E0", result->firstLine, result->lastLine, result->diagnostics.all());
+    }
+    else
+    {
+        diagnostics = std::move(result->diagnostics);
+        includedLibraries = result->includedLibraries;
+    }
+    diagnosticList->clear();
+    codeEditor->clearHighlights();
 
     // Hiển thị các thư viện đã include thành công
-    const auto &libs = preprocessor.getIncludedLibraries();
+    const auto &libs = includedLibraries;
     if (!libs.empty())
     {
         QString libList = "✓ Đã nhận diện: ";
@@ -287,32 +518,14 @@ void MainWindow::performAutoCheck()
         diagnosticList->addItem(item);
     }
 
-    // Bước 2: Lexer
-    Lexer lexer(processedCode);
-    std::vector<Token> tokens = lexer.tokenize();
-
-    // Bước 3: Parser với Semantics
-    Parser parser(tokens);
-    semantics sem;
-    sem.enterScope();
-
-    vector<string> libIdentifiers = preprocessor.getLibraryIdentifiers();
-    for (const auto &ident : libIdentifiers)
-    {
-        sem.LibraryFunction(ident);
-        dictionary.insert(ident);
-    }
-
-    parser.setSemantics(&sem);
-    parser.setDiagnosticReporter(&diagnostics);
-    parser.parseProgram();
-
-    // Cập nhật dictionary với các identifiers từ code
-    updateDictionaryFromCode();
-
     // Bước 4: Hiển thị kết quả
     const auto &items = diagnostics.all();
-    if (items.empty())
+    if (items.empty() && !complete)
+    {
+        // Tầng sau (đã lên lịch) sẽ quyết định mã có hợp lệ hay không
+        statusLabel->setText("Đang kiểm tra...");
+    }
+    else if (items.empty())
     {
         statusLabel->setText("✓ Không có lỗi");
         statusLabel->setStyleSheet(
@@ -337,7 +550,10 @@ void MainWindow::performAutoCheck()
 
         if (errorCount > 0)
         {
-            statusLabel->setText(QString("✗ Tìm thấy %1 lỗi").arg(errorCount));
+            QString text = QString("✗ Tìm thấy %1 lỗi").arg(errorCount);
+            if (!complete)
+                text += ", đang kiểm tra tiếp...";
+            statusLabel->setText(text);
             statusLabel->setStyleSheet(
                 "QLabel {"
                 "  padding: 5px;"
@@ -348,19 +564,14 @@ void MainWindow::performAutoCheck()
                 "}");
         }
 
-        for (const auto &diag : items)
+        for (size_t i = 0; i < items.size(); i++)
         {
-            QString severity = (diag.severity == DiagSeverity::Error) ? "🔴" : "⚠️";
-            QString msg = QString("%1 [Dòng %2, Cột %3] %4")
-                              .arg(severity)
-                              .arg(diag.line)
-                              .arg(diag.col)
-                              .arg(QString::fromStdString(diag.message));
-
-            QListWidgetItem *item = new QListWidgetItem(msg);
+            const auto &diag = items[i];
+            QListWidgetItem *item = new QListWidgetItem(diagnosticText(diag));
             item->setData(Qt::UserRole, diag.line);
             item->setData(Qt::UserRole + 1, diag.col);
             item->setData(Qt::UserRole + 2, diag.length);
+            item->setData(Qt::UserRole + 3, (int)i);
 
             if (diag.severity == DiagSeverity::Error)
                 item->setForeground(QColor(198, 40, 40));
@@ -371,6 +582,8 @@ void MainWindow::performAutoCheck()
         }
 
         highlightErrors();
+        // Gợi ý "did you mean" được tìm khi danh sách đã sắp xếp xong vị trí các dòng
+        QTimer::singleShot(0, this, &MainWindow::resolveVisibleDiagnostics);
     }
 }
 
@@ -387,22 +600,97 @@ void MainWindow::onCheckCode()
 void MainWindow::highlightErrors()
 {
     const auto &items = diagnostics.all();
-    for (const auto &diag : items)
+    for (size_t i = 0; i < items.size(); i++)
     {
+        const auto &diag = items[i];
         QColor color = (diag.severity == DiagSeverity::Error)
                            ? QColor(255, 205, 210)
                            : QColor(255, 245, 157);
-        codeEditor->highlightLine(diag.line, diag.col, diag.length, color);
+        QTextBlock block = codeEditor->document()->findBlockByNumber(diag.line - 1);
+        int col = editorColumn(block, diag.col);
+        int end = editorColumn(block, diag.col + diag.length);
+        codeEditor->highlightLine(diag.line, col, end - col, color, (int)i);
     }
 }
 
+QString MainWindow::diagnosticText(const DiagnosticItem &diag) const
+{
+    QString severity = (diag.severity == DiagSeverity::Error) ? "🔴" : "⚠️";
+    return QString("%1 [Dòng %2, Cột %3] %4")
+        .arg(severity)
+        .arg(diag.line)
+        .arg(diag.col)
+        .arg(QString::fromStdString(diag.message));
+}
+
+void MainWindow::refreshDiagnosticItems()
+{
+    const auto &items = diagnostics.all();
+    for (int row = 0; row < diagnosticList->count(); row++)
+    {
+        QListWidgetItem *item = diagnosticList->item(row);
+        QVariant index = item->data(Qt::UserRole + 3);
+        if (index.isValid() && index.toInt() < (int)items.size())
+            item->setText(diagnosticText(items[index.toInt()]));
+    }
+}
+
+void MainWindow::resolveVisibleDiagnostics()
+{
+    int count = diagnosticList->count();
+    if (count == 0)
+        return;
+
+    QModelIndex top = diagnosticList->indexAt(QPoint(0, 0));
+    QModelIndex bottom = diagnosticList->indexAt(QPoint(0, diagnosticList->viewport()->height() - 1));
+    int first = top.isValid() ? top.row() : 0;
+    int last = bottom.isValid() ? bottom.row() : count - 1;
+
+    std::vector<size_t> visible;
+    for (int row = first; row <= last; row++)
+    {
+        QVariant index = diagnosticList->item(row)->data(Qt::UserRole + 3);
+        if (index.isValid() && diagnostics.suggestionPending(index.toInt()))
+            visible.push_back(index.toInt());
+    }
+    if (visible.empty())
+        return;
+
+    // Một lần duyệt trie chung cho mọi dòng vừa hiện ra
+    diagnostics.resolveSuggestions(visible);
+    refreshDiagnosticItems();
+    updateTimingLabel();
+}
+
+void MainWindow::onHighlightHovered(int diagIndex, const QPoint &globalPos)
+{
+    const auto &items = diagnostics.all();
+    if (diagIndex < 0 || diagIndex >= (int)items.size())
+        return;
+
+    if (diagnostics.suggestionPending(diagIndex))
+    {
+        diagnostics.resolveSuggestions({(size_t)diagIndex});
+        refreshDiagnosticItems();
+        updateTimingLabel();
+    }
+    QToolTip::showText(globalPos, QString::fromStdString(items[diagIndex].message), codeEditor);
+}
+
 void MainWindow::onTextChanged()
 {
+    // Kết quả đang tính là của văn bản cũ: hủy để vị trí lỗi không bị lệch
+    cancelAnalysis();
+
+    debounce.recordKeystroke(typingClock.elapsed());
+
     // Nếu auto-check được bật, reset timer
     if (autoCheckBox->isChecked())
     {
         autoCheckTimer->stop();
-        autoCheckTimer->start(1500);
+        autoCheckTimer->start(debounce.delayMs());
+        updateTimingLabel();
+        runLexicalTier();
     }
 }
 
@@ -420,7 +708,7 @@ void MainWindow::onDiagnosticItemClicked(QListWidgetItem *item)
     QTextCursor cursor = codeEditor->textCursor();
     cursor.movePosition(QTextCursor::Start);
     cursor.movePosition(QTextCursor::Down, QTextCursor::MoveAnchor, line - 1);
-    cursor.movePosition(QTextCursor::Right, QTextCursor::MoveAnchor, col - 1);
+    cursor.movePosition(QTextCursor::Right, QTextCursor::MoveAnchor, editorColumn(cursor.block(), col) - 1);
 
     codeEditor->setTextCursor(cursor);
     codeEditor->setFocus();
@@ -430,7 +718,7 @@ void MainWindow::onAutoCheckToggled(int state)
 {
     if (state == Qt::Checked)
     {
-        autoCheckTimer->start(1500);
+        autoCheckTimer->start(debounce.delayMs());
         statusLabel->setText("✓ Đã bật tự động kiểm tra");
     }
     else
@@ -440,18 +728,37 @@ void MainWindow::onAutoCheckToggled(int state)
     }
 }
 
+void MainWindow::onFuzzyEngineChanged(int index)
+{
+    // Gửi qua hàng đợi của worker: không đổi engine giữa một lần phân tích
+    FuzzyEngine engine = (FuzzyEngine)fuzzyEngineBox->itemData(index).toInt();
+    AnalysisWorker *worker = analysisWorker;
+    QMetaObject::invokeMethod(
+        worker, [worker, engine]
+        { worker->setFuzzyEngine(engine); },
+        Qt::QueuedConnection);
+
+    // Gợi ý hiện tại được tính bằng engine cũ
+    performAutoCheck();
+}
+
 void MainWindow::onClearAll()
 {
     if (autoCheckTimer->isActive())
         autoCheckTimer->stop();
+    cancelAnalysis();
 
     codeEditor->clear();
     diagnosticList->clear();
     diagnostics.clear();
+    includedLibraries.clear();
+    suggestionSymbols.reset();
+    updateTimingLabel();
     codeEditor->clearHighlights();
 
+    visibleSymbols.reset();
+
     // Reset dictionary về keywords ban đầu
-    dictionary = Trie();
     populateDictionary();
 
     statusLabel->setText("Sẵn sàng");
@@ -1,9 +1,12 @@
 #pragma once
 #include "CodeEditor.h"
+#include "AnalysisWorker.h"
+#include "DebouncePolicy.h"
 #include "../lexer/Lexer.h"
 #include "../parser/Parser.h"
 #include "../Diagnostic/DiagnosticReporter.h"
 #include "../Trie/trie.h"
+#include "../Trie/concurrent_dictionary.h"
 
 #include <QMainWindow>
 #include <QTextEdit>
@@ -13,6 +16,12 @@
 #include <QLabel>
 #include <QTimer>
 #include <QCheckBox>
+#include <QComboBox>
+#include <QThread>
+#include <QElapsedTimer>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
 
 class MainWindow : public QMainWindow
 {
@@ -29,28 +38,72 @@ private slots:
     void onDiagnosticItemClicked(QListWidgetItem *item);
     void onClearAll();
     void onAutoCheckToggled(int);
+    void onFuzzyEngineChanged(int index);
+    void onSuggestionAccepted(const QString &text);
+    void onHighlightHovered(int diagIndex, const QPoint &globalPos);
+    // Kết quả của một tầng (từ worker hoặc tầng Lexical); bị bỏ qua nếu đã có
+    // yêu cầu mới hơn, còn không thì thay thế chẩn đoán của tầng trước
+    void onAnalysisFinished(std::shared_ptr<AnalysisResult> result);
+    // Chỉ chẩn đoán đang nằm trong vùng nhìn thấy của danh sách mới được tìm gợi ý
+    void resolveVisibleDiagnostics();
 
 private:
     void setupUI();
     void setupConnections();
     void updateSuggestions();
     void highlightErrors();
+    QString diagnosticText(const DiagnosticItem &diag) const;
+    // Cột (từ 1) theo cách lexer đếm, cho vị trí trong dòng của editor
+    static int sourceColumn(const QTextBlock &block, int positionInBlock);
+    // Ngược lại: cột (từ 1) theo ký tự của editor cho cột của lexer
+    static int editorColumn(const QTextBlock &block, int sourceCol);
+    // Cập nhật nội dung các dòng của danh sách sau khi gợi ý được giải
+    void refreshDiagnosticItems();
     void populateDictionary();
-    void updateDictionaryFromCode();
+    // Xếp một lô thay đổi dictionary sang luồng worker, theo thứ tự gửi
+    void queueDictionaryUpdate(std::function<void(CompletionDictionary &)> batch);
+    // Ảnh từ điển của phiên trước: nạp khi mở (mmap), ghi lại khi đóng
+    QString dictionaryImagePath() const;
+    void loadDictionaryImage();
+    void saveDictionaryImage();
+    // Gửi bản sao tài liệu cho worker phân tích
     void performAutoCheck();
+    // Tầng Lexical: lex vùng đang hiển thị ngay trên luồng UI
+    void runLexicalTier();
+    // Hủy lần phân tích đang chạy (nếu có): kết quả của nó sẽ không được áp dụng
+    void cancelAnalysis();
+    // Hiển thị thời gian chờ hiện tại, thời gian của lần kiểm tra gần nhất và
+    // tỉ lệ trúng cache gợi ý của lần đó
+    void updateTimingLabel();
 
     // UI Components
     CodeEditor *codeEditor;
     QListWidget *diagnosticList;
     QLabel *statusLabel;
+    QLabel *timingLabel;
     QPushButton *checkButton;
     QPushButton *clearButton;
     QTimer *autoCheckTimer;
+    // Thời gian chờ tự kiểm tra theo độ trễ đo được và nhịp gõ
+    DebouncePolicy debounce;
+    QElapsedTimer typingClock;
     QCheckBox *autoCheckBox;
+    QComboBox *fuzzyEngineBox;
 
     // Data
     DiagnosticReporter diagnostics;
-    Trie dictionary;
+    std::vector<std::string> includedLibraries; // Của lần kiểm tra đầy đủ gần nhất
+    // Completion đọc bản công bố, không chờ lần cập nhật từ phân tích
+    ConcurrentDictionary dictionary;
     std::vector<std::string> keywords;
     semantics currentSemantics;
+
+    // Phân tích nền: generation tăng ở mỗi yêu cầu/chỉnh sửa, worker so sánh để tự hủy
+    QThread *analysisThread;
+    AnalysisWorker *analysisWorker;
+    std::atomic<uint64_t> analysisGeneration{0};
+    // Ảnh chụp scope theo vị trí của lần kiểm tra gần nhất (chỉ dùng trên luồng UI)
+    std::shared_ptr<const SymbolTimeline> visibleSymbols;
+    // Bảng symbol giải gợi ý cho danh sách chẩn đoán hiện tại (chỉ dùng trên luồng UI)
+    std::shared_ptr<const SymbolTable> suggestionSymbols;
 };
\ No newline at end of file
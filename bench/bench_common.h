@@ -0,0 +1,82 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <cctype>
+#include <cstdlib>
+
+using namespace std;
+
+// Định danh sinh ngẫu nhiên (seed cố định) cho các benchmark: ghép 2-4 từ
+// kiểu camelCase/snake_case kèm số, vd. getBuffer_size417, tokenListEntry52
+inline vector<string> longIdentifiers(size_t count, unsigned seed = 7)
+{
+    static const char *parts[] = {"get", "set", "count", "index", "buffer", "read", "write", "size",
+                                  "node", "value", "total", "parse", "token", "symbol", "scope", "table",
+                                  "entry", "item", "list", "map", "user", "name", "file", "path"};
+    const size_t partCount = sizeof(parts) / sizeof(parts[0]);
+
+    mt19937 rng(seed);
+    unordered_set<string> seen;
+    vector<string> result;
+    while (result.size() < count)
+    {
+        string word;
+        int n = 2 + rng() % 3;
+        for (int i = 0; i < n; i++)
+        {
+            string part = parts[rng() % partCount];
+            if (i && rng() % 2)
+                part[0] = toupper(part[0]);
+            else if (i)
+                part = "_" + part;
+            word += part;
+        }
+        word += to_string(rng() % 1000);
+        if (seen.insert(word).second)
+            result.push_back(word);
+    }
+    return result;
+}
+
+// Tên ngắn kiểu biến cục bộ C: 3-8 chữ cái, đôi khi kèm một chữ số
+inline vector<string> shortIdentifiers(size_t count, unsigned seed = 11)
+{
+    mt19937 rng(seed);
+    unordered_set<string> seen;
+    vector<string> result;
+    while (result.size() < count)
+    {
+        string word;
+        int n = 3 + rng() % 6;
+        for (int i = 0; i < n; i++)
+            word += char('a' + rng() % 26);
+        if (rng() % 4 == 0)
+            word += char('0' + rng() % 10);
+        if (seen.insert(word).second)
+            result.push_back(word);
+    }
+    return result;
+}
+
+// Đối số dòng lệnh thứ index dạng số, hoặc fallback
+inline size_t argSize(int argc, char **argv, int index, size_t fallback)
+{
+    return argc > index ? strtoull(argv[index], nullptr, 10) : fallback;
+}
+
+class Stopwatch
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+public:
+    double ms() const { return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count(); }
+    double us() const { return ms() * 1000; }
+    void restart() { start = chrono::steady_clock::now(); }
+};
+
+#endif // BENCH_COMMON_H
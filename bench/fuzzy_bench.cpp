@@ -0,0 +1,69 @@
+// So sánh các engine fuzzy (A*, Levenshtein DP, automaton, SymSpell): độ trễ,
+// độ chính xác top-1 và bộ nhớ. Truy vấn là định danh có thật bị đảo ký tự
+// thứ 2 và 3 (lỗi gõ hay gặp nhất: "pirntf"); đúng nếu gợi ý đầu là từ gốc.
+// Cách dùng: fuzzy_bench [số định danh = 100000] [số truy vấn = 300]
+#include "trie.h"
+#include "bench_common.h"
+#include <cstdio>
+
+struct EngineCase
+{
+    FuzzyEngine engine;
+    const char *name;
+};
+
+static void run(const char *label, const vector<string> &ids, size_t queryCount)
+{
+    mt19937 rng(5);
+    vector<pair<string, string>> queries; // (truy vấn, từ gốc)
+    while (queries.size() < queryCount)
+    {
+        const string &word = ids[rng() % ids.size()];
+        if (word.size() < 4 || word[1] == word[2])
+            continue;
+        string typo = word;
+        swap(typo[1], typo[2]);
+        queries.push_back({typo, word});
+    }
+
+    printf("%s: %zu identifiers, %zu queries\n", label, ids.size(), queries.size());
+    const EngineCase engines[] = {{FuzzyEngine::AStar, "A*"},
+                                  {FuzzyEngine::Levenshtein, "Levenshtein DP"},
+                                  {FuzzyEngine::Automaton, "automaton"},
+                                  {FuzzyEngine::SymSpell, "SymSpell"}};
+    for (const EngineCase &c : engines)
+    {
+        Trie trie;
+        for (const string &word : ids)
+            trie.insert(word);
+        trie.setFuzzyEngine(c.engine);
+
+        // Chỉ mục lười (SymSpell) được dựng ở truy vấn đầu: tính riêng
+        Stopwatch timer;
+        trie.findSimilarWords(queries[0].first, 5);
+        double warmupMs = timer.ms();
+
+        size_t correct = 0;
+        timer.restart();
+        for (const auto &q : queries)
+        {
+            vector<string> found = trie.findSimilarWords(q.first, 5);
+            if (!found.empty() && found[0] == q.second)
+                correct++;
+        }
+        double totalMs = timer.ms();
+
+        printf("  %-15s %9.1f ms (%8.1f us/query), first query %7.1f ms, top-1 %zu/%zu, memoryUsage %.1f MB\n",
+               c.name, totalMs, totalMs * 1000 / queries.size(), warmupMs, correct, queries.size(),
+               trie.memoryUsage() / 1048576.0);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = argSize(argc, argv, 1, 100000);
+    size_t queries = argSize(argc, argv, 2, 300);
+    run("long identifiers", longIdentifiers(count), queries);
+    run("short identifiers", shortIdentifiers(count / 10), queries);
+    return 0;
+}
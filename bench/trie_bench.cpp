@@ -0,0 +1,43 @@
+// Trie: chèn, tìm theo tiền tố, xóa và bộ nhớ trên định danh sinh ngẫu nhiên
+// Cách dùng: trie_bench [số định danh = 100000] [số truy vấn tiền tố = 20000]
+#include "trie.h"
+#include "bench_common.h"
+#include <cstdio>
+
+int main(int argc, char **argv)
+{
+    size_t count = argSize(argc, argv, 1, 100000);
+    size_t queries = argSize(argc, argv, 2, 20000);
+    vector<string> ids = longIdentifiers(count);
+
+    Stopwatch timer;
+    Trie trie;
+    for (const string &word : ids)
+        trie.insert(word);
+    double insertMs = timer.ms();
+    size_t memory = trie.memoryUsage();
+
+    // Tiền tố 3-8 ký tự của định danh có thật, 10 kết quả mỗi truy vấn (như completion)
+    mt19937 rng(3);
+    size_t hits = 0;
+    timer.restart();
+    for (size_t i = 0; i < queries; i++)
+    {
+        const string &word = ids[rng() % ids.size()];
+        hits += trie.findWordsWithPrefix(word.substr(0, 3 + rng() % 6), 10).size();
+    }
+    double prefixMs = timer.ms();
+
+    timer.restart();
+    for (size_t i = 0; i < ids.size() / 2; i++)
+        trie.remove(ids[i]);
+    double removeMs = timer.ms();
+
+    printf("identifiers        %zu\n", ids.size());
+    printf("insert             %.1f ms\n", insertMs);
+    printf("memoryUsage        %.1f MB\n", memory / 1048576.0);
+    printf("prefix queries     %zu in %.1f ms (%.2f us/query, %zu results)\n", queries, prefixMs,
+           prefixMs * 1000 / queries, hits);
+    printf("remove half        %.1f ms, memoryUsage after %.1f MB\n", removeMs, trie.memoryUsage() / 1048576.0);
+    return 0;
+}
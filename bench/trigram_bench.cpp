@@ -0,0 +1,56 @@
+// Tìm đoạn con qua chỉ mục trigram (Trie::findWordsContaining): thời gian dựng,
+// bộ nhớ, độ trễ truy vấn chính xác và truy vấn có lỗi gõ
+// Cách dùng: trigram_bench [số định danh = 1000000]
+#include "trie.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <algorithm>
+
+static void measure(const Trie &trie, const char *label, const vector<string> &queries)
+{
+    double total = 0, worst = 0;
+    size_t hits = 0;
+    for (const string &q : queries)
+    {
+        Stopwatch timer;
+        hits += trie.findWordsContaining(q, 10).size();
+        double us = timer.us();
+        total += us;
+        worst = max(worst, us);
+    }
+    printf("  %-22s %zu queries, avg %7.1f us, max %7.1f us, %zu results\n", label, queries.size(),
+           total / queries.size(), worst, hits);
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = argSize(argc, argv, 1, 1000000);
+    vector<string> ids = longIdentifiers(count);
+
+    Trie trie;
+    for (const string &word : ids)
+        trie.insert(word);
+    size_t trieBytes = trie.memoryUsage();
+
+    Stopwatch timer;
+    trie.prepareIndexes();
+    double buildMs = timer.ms();
+
+    printf("identifiers  %zu\n", ids.size());
+    printf("trie         %.1f MB\n", trieBytes / 1048576.0);
+    printf("index        %.1f MB, built in %.1f ms\n", (trie.memoryUsage() - trieBytes) / 1048576.0, buildMs);
+
+    // Đoạn con 4-8 ký tự lấy từ giữa định danh có thật
+    mt19937 rng(9);
+    vector<string> exact;
+    for (int i = 0; i < 1000; i++)
+    {
+        const string &word = ids[rng() % ids.size()];
+        size_t length = min<size_t>(4 + rng() % 5, word.size());
+        exact.push_back(word.substr(rng() % (word.size() - length + 1), length));
+    }
+    measure(trie, "exact substring", exact);
+    measure(trie, "common words", {"count", "Buffer", "node_val", "size", "tokenList", "_path"});
+    measure(trie, "typos", {"bufferLst", "usrName", "tokenLsit", "symbl_table", "fileePath", "valeuMap"});
+    return 0;
+}
@@ -298,6 +298,23 @@ Token Lexer::makeOperatorOrSymbol()
 
 Lexer::Lexer(const string &src) : src(src) {}
 
+void Lexer::setDiagnosticReporter(DiagnosticReporter *reporter)
+{
+    diag = reporter;
+}
+
+void Lexer::reportError(const Token &tok)
+{
+    string msg;
+    if (tok.value[0] == '"')
+        msg = "chuỗi chưa được đóng";
+    else if (tok.value[0] == '\'')
+        msg = "hằng ký tự không hợp lệ";
+    else
+        msg = "hằng số không hợp lệ '" + tok.value + "'";
+    diag->lexical(msg, tok.line, tok.col, tok.length);
+}
+
 vector<Token> Lexer::tokenize()
 {
     vector<Token> tokens;
@@ -339,6 +356,8 @@ vector<Token> Lexer::tokenize()
             string s(1, get());
             tokens.emplace_back(s, TokenType::Unknown, startLine, startCol, 1);
         }
+        if (diag && tokens.back().type == TokenType::Error)
+            reportError(tokens.back());
     }
     return tokens;
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "Token.h"
+#include "../Diagnostic/DiagnosticReporter.h"
 
 #include <vector>
 #include <unordered_set>
@@ -11,6 +12,7 @@ private:
     const string &src;
     size_t i = 0;
     int line = 1, col = 1;
+    DiagnosticReporter *diag = nullptr;
 
     char peek(int);
     char get();
@@ -29,8 +31,11 @@ private:
     Token makeString();
     Token makeChar();
     Token makeOperatorOrSymbol();
+    void reportError(const Token &);
 
 public:
     Lexer(const string &src);
+    // Báo các token Error (số, chuỗi, ký tự sai) ngay khi lex
+    void setDiagnosticReporter(DiagnosticReporter *);
     vector<Token> tokenize();
 };
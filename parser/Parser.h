@@ -2,6 +2,7 @@
 #include "../lexer/Lexer.h"
 #include "../Diagnostic/DiagnosticReporter.h"
 #include "semantics.h"
+#include <functional>
 
 class Parser
 {
@@ -12,9 +13,19 @@ public:
     DiagnosticReporter *diag = nullptr;
 
     void setDiagnosticReporter(DiagnosticReporter *);
+    // Không gắn semantics thì parser chỉ kiểm tra cú pháp
     void setSemantics(semantics *);
+    // Kiểm tra hủy hợp tác: gọi trước mỗi hàm/khai báo toàn cục, trả về true để dừng
+    void setCancelCheck(function<bool()> check);
+    bool wasCancelled() const { return cancelled; }
+    // Gọi ở cùng các ranh giới đó, sau cancelCheck: cho phép gửi dần chẩn đoán
+    // đã có mà không chờ parse hết tài liệu
+    void setBoundaryCallback(function<void()> callback);
 
 private:
+    function<bool()> cancelCheck;
+    function<void()> boundaryCallback;
+    bool cancelled = false;
     const vector<Token> &t;
     TypeKind lastTypekind = TypeKind::Unknown;
     int p = 0;
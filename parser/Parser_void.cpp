@@ -13,6 +13,16 @@ void Parser::setSemantics(semantics *s)
     sem = s;
 }
 
+void Parser::setCancelCheck(function<bool()> check)
+{
+    cancelCheck = std::move(check);
+}
+
+void Parser::setBoundaryCallback(function<void()> callback)
+{
+    boundaryCallback = std::move(callback);
+}
+
 void Parser::setDiagnosticReporter(DiagnosticReporter *dr)
 {
     diag = dr;
@@ -30,7 +40,8 @@ const Token &Parser::LA(int k)
 void Parser::reportSyntax(const string &msg, const Token &tok)
 {
     ERROR++;
-    if (diag)
+    // Token Error đã được lexer báo (E0) tại cùng vị trí
+    if (diag && tok.type != TokenType::Error)
     {
         diag->syntax(msg, tok.line, tok.col, tok.length);
     }
@@ -283,6 +294,13 @@ void Parser::parseProgram()
 {
     while (!isEnd())
     {
+        if (cancelCheck && cancelCheck())
+        {
+            cancelled = true;
+            break;
+        }
+        if (boundaryCallback)
+            boundaryCallback();
         if (lookLikeFunction())
             parseFunction();
         else
@@ -296,13 +314,18 @@ void Parser::parseFunction()
 {
     parseType();
     Token identoken = expectIdent();
-    sem->beginFunction(lastTypekind, identoken);
+    if (sem)
+        sem->beginFunction(lastTypekind, identoken);
     expectSym("(");
     if (!isSym(")"))
         parseParamList();
     expectSym(")");
     parseBlock(true);
-    sem->endFunction();
+    if (sem)
+    {
+        sem->endFunction();
+        sem->checkpoint(LA(-1));
+    }
 }
 
 void Parser::parseDecl()
@@ -330,24 +353,26 @@ void Parser::parseParamList()
 {
     parseType();
     Token IdentToken = expectIdent();
-    sem->declareParam(lastTypekind, IdentToken);
+    if (sem)
+        sem->declareParam(lastTypekind, IdentToken);
     while (acceptSym(","))
     {
         parseType();
         IdentToken = expectIdent();
-        sem->declareParam(lastTypekind, IdentToken);
+        if (sem)
+            sem->declareParam(lastTypekind, IdentToken);
     }
 }
 
 void Parser::parseBlock(bool isFunctionBlock)
 {
-    if (!isFunctionBlock)
+    if (!isFunctionBlock && sem)
         sem->enterScope();
     expectSym("{");
     if (isEnd())
     {
         reportSyntax("thiếu '}' ", t.back());
-        if (!isFunctionBlock)
+        if (!isFunctionBlock && sem)
             sem->leaveScope();
         return;
     }
@@ -367,13 +392,16 @@ void Parser::parseBlock(bool isFunctionBlock)
     if (isEnd())
     {
         reportSyntax("thiếu '}' ", t.back());
-        if (!isFunctionBlock)
+        if (!isFunctionBlock && sem)
             sem->leaveScope();
         return;
     }
     expectSym("}");
-    if (!isFunctionBlock)
+    if (!isFunctionBlock && sem)
+    {
         sem->leaveScope();
+        sem->checkpoint(LA(-1));
+    }
 }
 
 void Parser::parseStmt()
@@ -434,7 +462,8 @@ void Parser::parseReturnStmt()
         parseExpr();
         hasExpr = true;
     }
-    sem->onReturnToken(LA(-1), hasExpr);
+    if (sem)
+        sem->onReturnToken(LA(-1), hasExpr);
     expectSym(";");
 }
 
@@ -650,7 +679,8 @@ void Parser::parsePrimary()
             if (p + 1 < (int)t.size() && LA(1).type == TokenType::Symbol && LA(1).value == "(")
             {
                 const Token nameTok = LA();
-                sem->useIdent(nameTok);
+                if (sem)
+                    sem->useIdent(nameTok);
                 upP();
                 expectSym("(");
                 if (!isSym(")"))
@@ -658,7 +688,8 @@ void Parser::parsePrimary()
                 expectSym(")");
                 return;
             }
-            sem->useIdent(LA()); // định danh thường
+            if (sem)
+                sem->useIdent(LA()); // định danh thường
             upP();
             return;
         }
@@ -4,21 +4,34 @@ semantics::semantics() : diag(nullptr),
                          inFunction(false),
                          currentFunc(),
                          currentRet(TypeKind::Void),
-                         funcTok("", TokenType::Unknown, 0, 0, 0) {};
+                         funcTok("", TokenType::Unknown, 0, 0, 0),
+                         sym(make_shared<SymbolTable>()) {};
 
 void semantics::setReporter(DiagnosticReporter *r)
 {
     diag = r;
+    if (diag)
+    {
+        // Giữ bảng symbol sống sau khi semantics bị hủy: chẩn đoán được giải khi
+        // hiển thị, qua cùng index và cache gợi ý của bảng
+        shared_ptr<SymbolTable> table = sym;
+        diag->setSuggestionResolver([table](const vector<size_t> &handles)
+                                    { return table->resolveDeferred(handles); });
+    }
 }
 
 // ===== Scope =====
 void semantics::enterScope()
 {
-    sym.enterScope();
+    sym->enterScope();
 }
 void semantics::leaveScope()
 {
-    sym.leaveScope();
+    sym->leaveScope();
+}
+void semantics::checkpoint(const Token &tok)
+{
+    sym->checkpoint(tok.line, tok.col + tok.length);
 }
 
 // ===== Hàm =====
@@ -30,12 +43,13 @@ void semantics::beginFunction(TypeKind retKind, const Token &nameTok)
     funcTok = nameTok;
 
     str_Symbol s{nameTok.value, true, retKind, nameTok};
-    if (!sym.declareSymbol(s))
+    if (!sym->declareSymbol(s))
     {
         if (diag)
             diag->redeclaration(nameTok.value, nameTok.line, nameTok.col, nameTok.length);
     }
     enterScope();
+    checkpoint(nameTok);
 }
 
 void semantics::endFunction()
@@ -53,11 +67,12 @@ void semantics::declareVar(TypeKind ty, const Token &nameTok)
 {
     str_Symbol s{nameTok.value, false, ty, nameTok};
 
-    if (!sym.declareSymbol(s))
+    if (!sym->declareSymbol(s))
     {
         if (diag)
             diag->redeclaration(nameTok.value, nameTok.line, nameTok.col, nameTok.length);
     }
+    checkpoint(nameTok);
 }
 
 void semantics::declareParam(TypeKind ty, const Token &nameTok)
@@ -68,23 +83,17 @@ void semantics::declareParam(TypeKind ty, const Token &nameTok)
 // ===== Sử dụng định danh =====
 void semantics::useIdent(const Token &identTok)
 {
-    if (sym.lookupSymbol(identTok.value) == nullptr)
+    if (sym->lookupSymbol(identTok.value) == nullptr)
     {
-        string suggestion;
-
-        vector<string> suggestions = sym.getSuggestions(identTok.value);
-
-        if (!suggestions.empty())
-        {
-            suggestion = suggestions[0];
-        }
-
         if (diag)
         {
-            diag->undeclared(identTok.value, identTok.line, identTok.col, identTok.length, suggestion);
+            // Chỉ ghi nhận scope hiện tại: fuzzy search chạy khi chẩn đoán được hiển thị
+            diag->undeclaredDeferred(identTok.value, identTok.line, identTok.col, identTok.length,
+                                     sym->deferSuggestion(identTok.value));
         }
     }
 }
+
 // ===== Return =====
 void semantics::onReturnToken(const Token &retTok, bool hasExpr)
 {
@@ -114,10 +123,10 @@ void semantics::LibraryFunction(const string &name)
     Token libToken(name, TokenType::Identifier, 0, 0, name.length());
     str_Symbol s{name, true, TypeKind::Unknown, libToken};
 
-    if (sym.scopes.empty())
+    if (sym->empty())
     {
-        sym.enterScope();
+        sym->enterScope();
     }
 
-    sym.declareSymbol(s);
+    sym->declareSymbol(s);
 }
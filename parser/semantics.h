@@ -11,12 +11,15 @@ class semantics
     Token funcTok;
 
 public:
-    SymbolTable sym;
+    // Dùng chung với bộ giải gợi ý của reporter (sống lâu hơn semantics)
+    shared_ptr<SymbolTable> sym;
     semantics();
     void setReporter(DiagnosticReporter *r);
 
     void enterScope();
     void leaveScope();
+    // Ghi ảnh chụp scope ngay sau token (dùng cho completion/hover)
+    void checkpoint(const Token &tok);
 
     void beginFunction(TypeKind retKind, const Token &nameTok);
     void endFunction();
@@ -115,27 +115,34 @@ vector<string> Preprocessor::getLibraryIdentifiers() const
     // Thêm identifiers từ các thư viện đã include
     for (const auto &lib : includedLibs)
     {
-        if (lib == "stdio.h" || lib == "cstdio")
-        {
-            identifiers.insert(identifiers.end(), {"printf", "scanf", "fprintf", "fscanf", "sprintf", "sscanf",
-                                                   "getchar", "putchar", "puts", "FILE"});
-        }
-        else if (lib == "math.h" || lib == "cmath")
-        {
-            identifiers.insert(identifiers.end(), {"sin", "cos", "tan", "asin", "acos", "atan", "atan2",
-                                                   "sqrt", "pow", "exp", "log", "log10", "ceil", "floor",
-                                                   "fabs", "abs", "round"});
-        }
-        else if (lib == "algorithm")
-        {
-            identifiers.insert(identifiers.end(), {"sort", "reverse", "max", "min", "swap",
-                                                   "find", "binary_search", "lower_bound", "upper_bound"});
-        }
+        vector<string> libIdentifiers = getLibraryIdentifiers(lib);
+        identifiers.insert(identifiers.end(), libIdentifiers.begin(), libIdentifiers.end());
     }
 
     return identifiers;
 }
 
+vector<string> Preprocessor::getLibraryIdentifiers(const string &lib)
+{
+    if (lib == "stdio.h" || lib == "cstdio")
+    {
+        return {"printf", "scanf", "fprintf", "fscanf", "sprintf", "sscanf",
+                "getchar", "putchar", "puts", "FILE"};
+    }
+    if (lib == "math.h" || lib == "cmath")
+    {
+        return {"sin", "cos", "tan", "asin", "acos", "atan", "atan2",
+                "sqrt", "pow", "exp", "log", "log10", "ceil", "floor",
+                "fabs", "abs", "round"};
+    }
+    if (lib == "algorithm")
+    {
+        return {"sort", "reverse", "max", "min", "swap",
+                "find", "binary_search", "lower_bound", "upper_bound"};
+    }
+    return {};
+}
+
 void Preprocessor::reset()
 {
     includedLibs.clear();
@@ -24,6 +24,8 @@ public:
     const unordered_set<string>& getIncludedLibraries() const;
     
     vector<string> getLibraryIdentifiers() const;
+    // Identifiers của một thư viện
+    static vector<string> getLibraryIdentifiers(const string& lib);
     
     void reset();
 };
\ No newline at end of file
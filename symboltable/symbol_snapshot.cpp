@@ -0,0 +1,196 @@
+#include "symbol_snapshot.h"
+#include "symboltable.h"
+#include <algorithm>
+
+namespace
+{
+    const int BITS = 5;
+    const int MAX_SHIFT = 60; // Hết bit hash -> node va chạm (danh sách tuyến tính)
+
+    int popcount32(uint32_t x)
+    {
+        int n = 0;
+        for (; x; x &= x - 1)
+            n++;
+        return n;
+    }
+}
+
+struct HamtEntry
+{
+    uint64_t hash;
+    shared_ptr<const str_Symbol> leaf;  // != nullptr nếu là lá
+    shared_ptr<const HamtNode> child;   // != nullptr nếu là node con
+};
+
+struct HamtNode
+{
+    uint32_t bitmap = 0;       // Không dùng ở node va chạm
+    vector<HamtEntry> entries; // Sắp theo thứ tự bit trong bitmap
+};
+
+static shared_ptr<const HamtNode> assoc(const shared_ptr<const HamtNode> &node, int shift,
+                                        uint64_t hash, const shared_ptr<const str_Symbol> &leaf,
+                                        bool &added);
+
+// Tạo node chứa hai lá có hash khác nhau (hoặc va chạm hoàn toàn)
+static shared_ptr<const HamtNode> mergeLeaves(int shift, const HamtEntry &a, const HamtEntry &b)
+{
+    auto node = make_shared<HamtNode>();
+    if (shift >= MAX_SHIFT)
+    {
+        node->entries = {a, b};
+        return node;
+    }
+
+    uint32_t ia = (a.hash >> shift) & 31;
+    uint32_t ib = (b.hash >> shift) & 31;
+    if (ia == ib)
+    {
+        node->bitmap = 1u << ia;
+        node->entries.push_back({a.hash, nullptr, mergeLeaves(shift + BITS, a, b)});
+    }
+    else
+    {
+        node->bitmap = (1u << ia) | (1u << ib);
+        if (ia < ib)
+            node->entries = {a, b};
+        else
+            node->entries = {b, a};
+    }
+    return node;
+}
+
+static shared_ptr<const HamtNode> assoc(const shared_ptr<const HamtNode> &node, int shift,
+                                        uint64_t hash, const shared_ptr<const str_Symbol> &leaf,
+                                        bool &added)
+{
+    if (shift >= MAX_SHIFT)
+    {
+        auto copy = make_shared<HamtNode>(*node);
+        for (auto &e : copy->entries)
+        {
+            if (e.leaf->name == leaf->name)
+            {
+                e.leaf = leaf;
+                return copy;
+            }
+        }
+        copy->entries.push_back({hash, leaf, nullptr});
+        added = true;
+        return copy;
+    }
+
+    uint32_t bit = 1u << ((hash >> shift) & 31);
+    int idx = popcount32(node->bitmap & (bit - 1));
+    auto copy = make_shared<HamtNode>(*node);
+
+    if (!(node->bitmap & bit))
+    {
+        copy->bitmap |= bit;
+        copy->entries.insert(copy->entries.begin() + idx, {hash, leaf, nullptr});
+        added = true;
+        return copy;
+    }
+
+    HamtEntry &e = copy->entries[idx];
+    if (e.child)
+    {
+        e.child = assoc(e.child, shift + BITS, hash, leaf, added);
+    }
+    else if (e.hash == hash && e.leaf->name == leaf->name)
+    {
+        e.leaf = leaf; // Che khuất binding cũ
+    }
+    else
+    {
+        HamtEntry old = e;
+        e = {hash, nullptr, mergeLeaves(shift + BITS, old, {hash, leaf, nullptr})};
+        added = true;
+    }
+    return copy;
+}
+
+SymbolSnapshot SymbolSnapshot::with(const str_Symbol &sym) const
+{
+    uint64_t hash = std::hash<string>{}(sym.name);
+    auto leaf = make_shared<const str_Symbol>(sym);
+    bool added = false;
+    auto base = root ? root : make_shared<const HamtNode>();
+    auto newRoot = assoc(base, 0, hash, leaf, added);
+    return SymbolSnapshot(newRoot, count + (added ? 1 : 0));
+}
+
+const str_Symbol *SymbolSnapshot::lookup(const string &name) const
+{
+    uint64_t hash = std::hash<string>{}(name);
+    const HamtNode *node = root.get();
+    int shift = 0;
+
+    while (node)
+    {
+        if (shift >= MAX_SHIFT)
+        {
+            for (const auto &e : node->entries)
+                if (e.leaf->name == name)
+                    return e.leaf.get();
+            return nullptr;
+        }
+
+        uint32_t bit = 1u << ((hash >> shift) & 31);
+        if (!(node->bitmap & bit))
+            return nullptr;
+
+        const HamtEntry &e = node->entries[popcount32(node->bitmap & (bit - 1))];
+        if (!e.child)
+            return (e.hash == hash && e.leaf->name == name) ? e.leaf.get() : nullptr;
+
+        node = e.child.get();
+        shift += BITS;
+    }
+    return nullptr;
+}
+
+static void forEachNode(const HamtNode *node, const function<void(const str_Symbol &)> &fn)
+{
+    for (const auto &e : node->entries)
+    {
+        if (e.child)
+            forEachNode(e.child.get(), fn);
+        else
+            fn(*e.leaf);
+    }
+}
+
+void SymbolSnapshot::forEach(const function<void(const str_Symbol &)> &fn) const
+{
+    if (root)
+        forEachNode(root.get(), fn);
+}
+
+void SymbolTimeline::record(int line, int col, const SymbolSnapshot &scope)
+{
+    // Cùng vị trí: ảnh chụp sau ghi đè ảnh chụp trước
+    if (!points.empty() && points.back().line == line && points.back().col == col)
+    {
+        points.back().scope = scope;
+        return;
+    }
+    points.push_back({line, col, scope});
+}
+
+SymbolSnapshot SymbolTimeline::visibleAt(int line, int col) const
+{
+    // Checkpoint cuối cùng có vị trí <= (line, col)
+    auto it = upper_bound(points.begin(), points.end(), make_pair(line, col),
+                          [](const pair<int, int> &pos, const SymbolCheckpoint &p)
+                          { return pos < make_pair(p.line, p.col); });
+    if (it == points.begin())
+        return SymbolSnapshot();
+    return prev(it)->scope;
+}
+
+bool SymbolTimeline::empty() const
+{
+    return points.empty();
+}
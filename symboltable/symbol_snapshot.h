@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+using namespace std;
+
+struct str_Symbol;
+struct HamtNode;
+
+// Ảnh chụp bất biến của tập symbol nhìn thấy được (HAMT, chia sẻ cấu trúc).
+// Thêm một symbol chỉ sao chép đường đi từ gốc (O(log32 n)); các ảnh chụp
+// cũ không bao giờ bị sửa nên có thể đọc từ thread khác mà không cần khóa.
+class SymbolSnapshot
+{
+    shared_ptr<const HamtNode> root;
+    size_t count = 0;
+
+    explicit SymbolSnapshot(shared_ptr<const HamtNode> r, size_t n) : root(move(r)), count(n) {}
+
+public:
+    SymbolSnapshot() = default;
+
+    // Trả về ảnh chụp mới có thêm (hoặc che khuất bằng) sym
+    SymbolSnapshot with(const str_Symbol &sym) const;
+    const str_Symbol *lookup(const string &name) const;
+    void forEach(const function<void(const str_Symbol &)> &fn) const;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
+// Dãy ảnh chụp theo vị trí trong mã nguồn, ghi theo thứ tự parser đi qua
+struct SymbolCheckpoint
+{
+    int line;
+    int col;
+    SymbolSnapshot scope;
+};
+
+class SymbolTimeline
+{
+    vector<SymbolCheckpoint> points;
+
+public:
+    void record(int line, int col, const SymbolSnapshot &scope);
+    // Tập symbol nhìn thấy được tại (line, col)
+    SymbolSnapshot visibleAt(int line, int col) const;
+    bool empty() const;
+};
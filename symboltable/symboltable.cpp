@@ -1,58 +1,286 @@
 #include "symboltable.h"
+#include <functional>
 #include <algorithm>
+#include <thread>
 
-ScopeLayer::ScopeLayer() : trie(make_unique<Trie>()) {}
+SymbolTable::SymbolTable()
+    : slots(64, -1), positions(make_shared<SymbolTimeline>()) {}
+
+int SymbolTable::findName(const string &name, size_t hash) const
+{
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask)
+    {
+        int id = slots[i];
+        if (id < 0)
+            return -1;
+        if (nameHashes[id] == hash && names[id] == name)
+            return id;
+    }
+}
+
+void SymbolTable::growSlots()
+{
+    vector<int> bigger(slots.size() * 2, -1);
+    size_t mask = bigger.size() - 1;
+    for (int id = 0; id < (int)names.size(); id++)
+    {
+        size_t i = nameHashes[id] & mask;
+        while (bigger[i] >= 0)
+            i = (i + 1) & mask;
+        bigger[i] = id;
+    }
+    slots.swap(bigger);
+}
+
+int SymbolTable::internName(const string &name)
+{
+    size_t hash = std::hash<string>{}(name);
+    int id = findName(name, hash);
+    if (id >= 0)
+        return id;
+
+    // Giữ load factor <= 0.5 để chuỗi dò ngắn
+    if ((names.size() + 1) * 2 > slots.size())
+        growSlots();
+
+    id = names.size();
+    names.push_back(name);
+    nameHashes.push_back(hash);
+    heads.push_back(-1);
+
+    size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+    while (slots[i] >= 0)
+        i = (i + 1) & mask;
+    slots[i] = id;
+    return id;
+}
 
 void SymbolTable::enterScope()
 {
-    scopes.emplace_back();
+    scopeMarks.push_back(bindings.size());
+    savedSnapshots.push_back(current);
 }
 
 void SymbolTable::leaveScope()
 {
-    if (!scopes.empty())
-        scopes.pop_back();
+    if (scopeMarks.empty())
+        return;
+
+    // Pop undo log: khôi phục binding bị che khuất của từng tên
+    size_t mark = scopeMarks.back();
+    if (bindings.size() > mark)
+        visibleVersion++;
+    while (bindings.size() > mark)
+    {
+        const SymbolBinding &b = bindings.back();
+        heads[b.nameId] = b.shadowed;
+        bindings.pop_back();
+    }
+    scopeMarks.pop_back();
+
+    // Rời scope chỉ cần quay lại ảnh chụp đã lưu
+    current = savedSnapshots.back();
+    savedSnapshots.pop_back();
 }
 
 bool SymbolTable::declareSymbol(str_Symbol sym)
 {
-    if (scopes.empty())
+    if (scopeMarks.empty())
         enterScope();
-    
-    auto &top = scopes.back();
 
-    if (top.symbols.find(sym.name) != top.symbols.end())
+    int id = internName(sym.name);
+    int top = heads[id];
+    if (top >= 0 && bindings[top].depth == depth())
         return false;
 
-    top.symbols.emplace(sym.name, sym);
-    top.trie->insert(sym.name);
-    
+    if (suggestionIndex)
+        suggestionIndex->insert(sym.name);
+
+    bindings.push_back({move(sym), id, depth(), top});
+    heads[id] = bindings.size() - 1;
+    visibleVersion++;
+    current = current.with(bindings.back().sym);
     return true;
 }
 
 str_Symbol *SymbolTable::lookupSymbol(const string &name)
 {
-    for (int i = scopes.size() - 1; i >= 0; i--)
+    int id = findName(name, std::hash<string>{}(name));
+    if (id < 0 || heads[id] < 0)
+        return nullptr;
+    return &bindings[heads[id]].sym;
+}
+
+bool SymbolTable::isVisible(const string &name) const
+{
+    int id = findName(name, std::hash<string>{}(name));
+    return id >= 0 && heads[id] >= 0;
+}
+
+void SymbolTable::buildSuggestionIndex()
+{
+    suggestionIndex = make_unique<Trie>();
+    suggestionIndex->setFuzzyEngine(suggestionEngine);
+    // Mọi tên từng khai báo: truy vấn hoãn lại có thể thuộc scope đã rời
+    for (const auto &name : names)
+        suggestionIndex->insert(name);
+}
+
+vector<string> SymbolTable::getSuggestions(const string &name, int maxSuggestions)
+{
+    return getSuggestionsBatch({suggestionQuery(name)}, maxSuggestions)[0];
+}
+
+size_t SymbolTable::deferSuggestion(const string &name)
+{
+    deferredQueries.push_back(suggestionQuery(name));
+    return deferredQueries.size() - 1;
+}
+
+vector<string> SymbolTable::resolveDeferred(const vector<size_t> &handles)
+{
+    vector<string> result(handles.size());
+    vector<SuggestionQuery> queries;
+    vector<size_t> slots;
+    for (size_t i = 0; i < handles.size(); i++)
+    {
+        if (handles[i] < deferredQueries.size())
+        {
+            queries.push_back(deferredQueries[handles[i]]);
+            slots.push_back(i);
+        }
+    }
+
+    vector<vector<string>> found = getSuggestionsBatch(queries, 1);
+    for (size_t q = 0; q < found.size(); q++)
     {
-        auto it = scopes[i].symbols.find(name);
-        if (it != scopes[i].symbols.end())
-            return &it->second;
+        if (!found[q].empty())
+            result[slots[q]] = found[q][0];
     }
-    return nullptr;
+    return result;
+}
+
+SuggestionQuery SymbolTable::suggestionQuery(const string &name) const
+{
+    return {name, current, visibleVersion};
 }
 
-vector<string> SymbolTable::getSuggestions(const string &name)
+vector<vector<string>> SymbolTable::getSuggestionsBatch(const vector<SuggestionQuery> &queries, int maxSuggestions)
 {
-    vector<string> allSuggestions;
-    
-    for (int i = scopes.size() - 1; i >= 0; i--)
+    vector<vector<string>> results(queries.size());
+
+    // Lấy từ cache trước; các truy vấn trùng (tên, phiên bản) chỉ tìm một lần
+    vector<string> pendingNames;
+    vector<const SuggestionQuery *> pending;
+    vector<size_t> slotOf(queries.size());
+    unordered_map<string, size_t> pendingSlot;
+    for (size_t i = 0; i < queries.size(); i++)
     {
-        vector<string> scopeSuggestions = scopes[i].trie->findSimilarWords(name, 2); 
-        allSuggestions.insert(allSuggestions.end(), scopeSuggestions.begin(), scopeSuggestions.end());
+        const SuggestionQuery &q = queries[i];
+        auto cached = suggestionCache.find(q.name);
+        if (cached != suggestionCache.end() && cached->second.version == q.version &&
+            cached->second.maxSuggestions >= maxSuggestions)
+        {
+            cacheStats.hits++;
+            const vector<string> &best = cached->second.result;
+            results[i].assign(best.begin(), best.begin() + min<size_t>(best.size(), max(maxSuggestions, 0)));
+            slotOf[i] = SIZE_MAX;
+            continue;
+        }
+
+        // Truy vấn trùng trong cùng lô dùng chung kết quả: cũng tính là trúng cache
+        string key = q.name + '\0' + to_string(q.version);
+        auto found = pendingSlot.find(key);
+        if (found == pendingSlot.end())
+        {
+            cacheStats.misses++;
+            found = pendingSlot.emplace(key, pending.size()).first;
+            pending.push_back(&q);
+            pendingNames.push_back(q.name);
+        }
+        else
+            cacheStats.hits++;
+        slotOf[i] = found->second;
     }
+    if (pending.empty())
+        return results;
 
-    sort(allSuggestions.begin(), allSuggestions.end());
-    allSuggestions.erase(unique(allSuggestions.begin(), allSuggestions.end()), allSuggestions.end());
+    if (!suggestionIndex)
+        buildSuggestionIndex();
 
-    return allSuggestions;
-}
\ No newline at end of file
+    vector<vector<string>> found;
+    if (suggestionEngine == FuzzyEngine::Automaton)
+    {
+        // Lô lớn chia cho nhiều luồng; trie và bảng chỉ được đọc trong lúc tìm
+        const size_t QUERIES_PER_THREAD = 16;
+        int threads = (int)min<size_t>(max(1u, thread::hardware_concurrency()),
+                                       (pending.size() + QUERIES_PER_THREAD - 1) / QUERIES_PER_THREAD);
+
+        found = suggestionIndex->findSimilarWordsBatch(
+            pendingNames, maxSuggestions,
+            [&](size_t q, const string &candidate) { return pending[q]->scope.lookup(candidate) != nullptr; },
+            threads);
+    }
+    else
+    {
+        // Engine khác không có lần duyệt chung: tìm từng truy vấn đã khử trùng
+        for (const SuggestionQuery *q : pending)
+        {
+            found.push_back(suggestionIndex->findSimilarWords(
+                q->name, maxSuggestions,
+                [q](const string &candidate) { return q->scope.lookup(candidate) != nullptr; }));
+        }
+    }
+
+    for (size_t p = 0; p < pending.size(); p++)
+        suggestionCache[pending[p]->name] = {pending[p]->version, maxSuggestions, found[p]};
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+        if (slotOf[i] != SIZE_MAX)
+            results[i] = found[slotOf[i]];
+    }
+    return results;
+}
+
+const SuggestionCacheStats &SymbolTable::suggestionCacheStats() const
+{
+    return cacheStats;
+}
+
+void SymbolTable::setFuzzyEngine(FuzzyEngine engine)
+{
+    if (engine == suggestionEngine)
+        return;
+    suggestionEngine = engine;
+    if (suggestionIndex)
+        suggestionIndex->setFuzzyEngine(engine);
+    // Engine khác có thể xếp hạng khác: kết quả cũ không còn dùng được
+    suggestionCache.clear();
+}
+
+SymbolSnapshot SymbolTable::snapshot() const
+{
+    return current;
+}
+
+void SymbolTable::checkpoint(int line, int col)
+{
+    positions->record(line, col, current);
+}
+
+shared_ptr<const SymbolTimeline> SymbolTable::timeline() const
+{
+    return positions;
+}
+
+int SymbolTable::depth() const
+{
+    return scopeMarks.size();
+}
+
+bool SymbolTable::empty() const
+{
+    return scopeMarks.empty();
+}
@@ -1,11 +1,13 @@
 #pragma once
 #include "type.h"
 #include "..\lexer\Token.h"
-#include "..\Trie\trie.h" 
+#include "..\Trie\trie.h"
+#include "symbol_snapshot.h"
 #include <string>
 #include <vector>
+#include <memory>
 #include <unordered_map>
-#include <memory> 
+#include <cstdint>
 using namespace std;
 
 struct str_Symbol
@@ -16,22 +18,112 @@ struct str_Symbol
     Token tkn;
 };
 
-struct ScopeLayer 
+// Một lần khai báo: nằm trong chuỗi che khuất (shadowing chain) của tên
+struct SymbolBinding
 {
-    unordered_map<string, str_Symbol> symbols;
-    unique_ptr<Trie> trie; 
+    str_Symbol sym;
+    int nameId;   // ID của tên đã intern
+    int depth;    // Độ sâu scope khai báo
+    int shadowed; // Binding cùng tên ở scope ngoài (-1 nếu không có)
+};
+
+// Thống kê cache gợi ý "did you mean"
+struct SuggestionCacheStats
+{
+    size_t hits = 0;
+    size_t misses = 0;
 
-    ScopeLayer();
+    double hitRate() const { return hits + misses ? (double)hits / (hits + misses) : 0.0; }
+};
+
+// Truy vấn gợi ý hoãn lại: ghi nhận tập symbol nhìn thấy tại thời điểm dùng tên
+// (ảnh chụp bất biến), nên giải được theo lô cả sau khi parse xong
+struct SuggestionQuery
+{
+    string name;
+    SymbolSnapshot scope; // Các symbol được phép gợi ý
+    uint64_t version;     // visibleVersion lúc dùng tên (khóa cache)
 };
 
 class SymbolTable
 {
+    // Bảng băm địa chỉ mở: slot -> nameId (-1 = trống)
+    vector<int> slots;
+    vector<string> names;       // nameId -> tên
+    vector<size_t> nameHashes;  // nameId -> hash (để rehash không phải băm lại)
+    vector<int> heads;          // nameId -> binding trong cùng (-1 = không nhìn thấy)
+
+    // Undo log: bindings được push theo thứ tự khai báo,
+    // scopeMarks lưu kích thước bindings khi vào mỗi scope
+    vector<SymbolBinding> bindings;
+    vector<size_t> scopeMarks;
+
+    // Một trie gợi ý chung cho mọi scope. Chỉ được dựng (lười) khi lần đầu
+    // cần gợi ý, sau đó cập nhật dần theo khai báo. Từ trong trie có thể đã
+    // ra khỏi scope: tính nhìn thấy lấy từ ảnh chụp của từng truy vấn.
+    unique_ptr<Trie> suggestionIndex;
+    FuzzyEngine suggestionEngine = FuzzyEngine::Automaton;
+
+    // Phiên bản tập symbol nhìn thấy được: tăng khi có khai báo mới
+    // hoặc khi rời scope làm mất binding. Kết quả gợi ý được cache theo
+    // (tên, phiên bản) nên lỗi lặp lại chỉ tốn một lần tra bảng băm.
+    // Cache giữ kết quả với maxSuggestions lớn nhất đã tính; yêu cầu nhỏ
+    // hơn lấy phần đầu, yêu cầu lớn hơn phải tìm lại.
+    uint64_t visibleVersion = 0;
+    struct CachedSuggestions
+    {
+        uint64_t version;
+        int maxSuggestions;
+        vector<string> result;
+    };
+    unordered_map<string, CachedSuggestions> suggestionCache;
+    SuggestionCacheStats cacheStats;
+
+    // Bản persistent song song với bảng phẳng: mỗi scope là một ảnh chụp
+    // chia sẻ cấu trúc, giữ lại theo vị trí để completion/hover truy vấn
+    SymbolSnapshot current;
+    vector<SymbolSnapshot> savedSnapshots;
+    shared_ptr<SymbolTimeline> positions;
+
+    // Gợi ý hoãn lại (handle = chỉ số), giải khi chẩn đoán được hiển thị
+    vector<SuggestionQuery> deferredQueries;
+
+    int findName(const string &name, size_t hash) const;
+    int internName(const string &name);
+    void growSlots();
+    void buildSuggestionIndex();
+
 public:
-    vector<ScopeLayer> scopes;
-    
+    SymbolTable();
+
     void enterScope();
     void leaveScope();
     bool declareSymbol(str_Symbol );
+    // Con trỏ chỉ hợp lệ đến lần declareSymbol/leaveScope tiếp theo
     str_Symbol *lookupSymbol(const string &);
-    vector<string> getSuggestions(const string &);
-};
\ No newline at end of file
+    vector<string> getSuggestions(const string &, int maxSuggestions = 3);
+    // Ghi nhận truy vấn tại vị trí hiện tại để giải quyết sau bằng getSuggestionsBatch
+    SuggestionQuery suggestionQuery(const string &name) const;
+    // Gợi ý cho nhiều tên, mỗi truy vấn chỉ nhận symbol trong ảnh chụp của nó.
+    // Engine Automaton (mặc định) tìm cả lô trong một lần duyệt trie chung; engine
+    // khác tìm từng truy vấn. Truy vấn trùng (tên, phiên bản) chỉ tìm một lần và
+    // kết quả được cache.
+    vector<vector<string>> getSuggestionsBatch(const vector<SuggestionQuery> &queries, int maxSuggestions = 3);
+    // Ghi nhận truy vấn gợi ý với scope hiện tại, trả về handle cho resolveDeferred
+    size_t deferSuggestion(const string &name);
+    // Gợi ý tốt nhất cho từng handle ("" nếu không có), qua getSuggestionsBatch
+    vector<string> resolveDeferred(const vector<size_t> &handles);
+    bool isVisible(const string &name) const;
+    const SuggestionCacheStats &suggestionCacheStats() const;
+    // Chọn engine fuzzy cho gợi ý (vd. SymSpell khi có rất nhiều định danh)
+    void setFuzzyEngine(FuzzyEngine engine);
+
+    // Ảnh chụp bất biến của các symbol đang nhìn thấy
+    SymbolSnapshot snapshot() const;
+    // Ghi lại ảnh chụp hiện tại cho vị trí (line, col) trong mã nguồn
+    void checkpoint(int line, int col);
+    shared_ptr<const SymbolTimeline> timeline() const;
+
+    int depth() const;
+    bool empty() const;
+};
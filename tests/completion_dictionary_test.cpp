@@ -0,0 +1,168 @@
+#include "completion_dictionary.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+    do                                                                     \
+    {                                                                      \
+        if (!(cond))                                                       \
+        {                                                                  \
+            cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed\n"; \
+            failures++;                                                    \
+        }                                                                  \
+    } while (0)
+
+static bool contains(const vector<string> &found, const string &word)
+{
+    return find(found.begin(), found.end(), word) != found.end();
+}
+
+static bool suggests(const CompletionDictionary &d, const string &prefix, const string &word)
+{
+    return contains(d.findWordsWithPrefix(prefix, 50), word);
+}
+
+static const string IMAGE_PATH = "completion_dictionary_test.img";
+
+// Cách viết trong mã che cách viết đã ghim; tên rời khỏi mã thì cách viết ghim hiện lại
+static void pinnedSpellingComesBack()
+{
+    CompletionDictionary d;
+    d.pin("printf");
+    d.applyCounts({{"Printf", 1}});
+    CHECK(suggests(d, "pri", "Printf"));
+
+    d.applyCounts({});
+    CHECK(suggests(d, "pri", "printf"));
+    CHECK(!suggests(d, "pri", "Printf"));
+
+    d.unpin("printf");
+    CHECK(!suggests(d, "pri", "printf"));
+}
+
+static void librarySpellingComesBack()
+{
+    CompletionDictionary d;
+    d.setLibraries({{"stdio.h", {"printf", "puts"}}});
+    d.applyCounts({{"PUTS", 2}});
+    CHECK(suggests(d, "pu", "PUTS"));
+
+    d.applyCounts({});
+    CHECK(suggests(d, "pu", "puts"));
+    CHECK(!suggests(d, "pu", "PUTS"));
+
+    // Bỏ #include khi tên vẫn dùng trong mã: giữ cách viết trong mã
+    d.applyCounts({{"Puts", 1}});
+    d.setLibraries({});
+    CHECK(suggests(d, "pu", "Puts"));
+    CHECK(!suggests(d, "pri", "printf"));
+
+    d.applyCounts({});
+    CHECK(!suggests(d, "pu", "Puts"));
+}
+
+// Hai nguồn ghim cùng tên: chỉ nhả khi cả hai đã nhả
+static void sharedPinOutlivesOneSource()
+{
+    CompletionDictionary d;
+    d.setLibraries({{"math.h", {"abs", "sqrt"}}, {"stdlib.h", {"abs"}}});
+    d.applyCounts({{"Abs", 1}});
+    d.setLibraries({{"stdlib.h", {"abs"}}});
+    d.applyCounts({});
+    CHECK(suggests(d, "ab", "abs"));
+    CHECK(!suggests(d, "sq", "sqrt"));
+
+    d.setLibraries({});
+    CHECK(!suggests(d, "ab", "abs"));
+}
+
+// Ảnh nền vẫn được dùng sau lần phân tích đầu; tên bị xóa khỏi tài liệu bị ẩn
+static void baseImageOutlivesAnalysis()
+{
+    CHECK(TrieImage::save(IMAGE_PATH, {{"getCharCount", 5}, {"oldHelper", 3}, {"readBufferSize", 1}}));
+    shared_ptr<const TrieImage> image = TrieImage::load(IMAGE_PATH);
+    CHECK(image != nullptr);
+    if (!image)
+        return;
+
+    CompletionDictionary d;
+    d.setBaseImage(image);
+    d.applyCounts({{"getCharCount", 1}});
+    CHECK(suggests(d, "old", "oldHelper"));
+    CHECK(contains(d.findWordsByAbbreviation("rbs"), "readBufferSize"));
+    CHECK(contains(d.findSimilarWords("oldHelpr"), "oldHelper"));
+
+    d.applyCounts({{"getCharCount", 1}, {"oldHelper", 1}});
+    d.applyCounts({{"getCharCount", 1}});
+    CHECK(!suggests(d, "old", "oldHelper"));
+    CHECK(!contains(d.findSimilarWords("oldHelpr"), "oldHelper"));
+
+    // Phiên sau: tên bị xóa không được ghi, tên còn dùng giữ nửa trọng số cũ
+    vector<pair<string, uint32_t>> entries = d.imageEntries();
+    auto entry = [&](const string &word)
+    {
+        for (const auto &e : entries)
+            if (e.first == word)
+                return (int)e.second;
+        return -1;
+    };
+    CHECK(entry("oldHelper") == -1);
+    CHECK(entry("getCharCount") == 1 + 5 / 2);
+    CHECK(entry("readBufferSize") == -1); // Trọng số giảm về 0
+
+    // Tên quay lại tài liệu thì không còn bị ẩn
+    d.applyCounts({{"oldHelper", 1}});
+    d.setBaseImage(nullptr);
+    d.setBaseImage(image);
+    CHECK(suggests(d, "old", "oldHelper"));
+    image.reset();
+    d.setBaseImage(nullptr);
+    remove(IMAGE_PATH.c_str());
+}
+
+// Node hỏng chỉ được phát hiện khi truy vấn chạm tới: bị bỏ qua, không đọc ra ngoài ảnh
+static void corruptNodeIsSkipped()
+{
+    CHECK(TrieImage::save(IMAGE_PATH, {{"alpha", 1}, {"beta", 2}, {"betamax", 3}}));
+    {
+        // Node 1 là 'a' (con đầu của gốc): đặt wordEnd ra ngoài bảng từ
+        fstream file(IMAGE_PATH, ios::in | ios::out | ios::binary);
+        uint32_t bad = 0x7FFFFFFF;
+        file.seekp(sizeof(TrieImage::Header) + sizeof(TrieImage::Node) + offsetof(TrieImage::Node, wordEnd));
+        file.write(reinterpret_cast<const char *>(&bad), sizeof(bad));
+    }
+    shared_ptr<const TrieImage> image = TrieImage::load(IMAGE_PATH);
+    CHECK(image != nullptr);
+    if (image)
+    {
+        CHECK(image->findWordsWithPrefix("al").empty());
+        CHECK(!image->contains("alpha"));
+        CHECK(image->findWordsWithPrefix("be").size() == 2);
+        CHECK(contains(image->findSimilarWords("betamx"), "betamax"));
+    }
+    image.reset();
+    remove(IMAGE_PATH.c_str());
+}
+
+int main()
+{
+    pinnedSpellingComesBack();
+    librarySpellingComesBack();
+    sharedPinOutlivesOneSource();
+    baseImageOutlivesAnalysis();
+    corruptNodeIsSkipped();
+
+    if (failures)
+    {
+        cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    cout << "completion_dictionary_test: OK\n";
+    return 0;
+}